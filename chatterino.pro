@@ -96,7 +96,22 @@ SOURCES += \
     src/messagefactory.cpp \
     src/widgets/basewidget.cpp \
     src/widgets/resizingtextedit.cpp \
-    src/completionmanager.cpp
+    src/completionmanager.cpp \
+    src/twitch/rawircmessage.cpp \
+    src/twitch/twitchconnection.cpp \
+    src/twitch/readconnectionpool.cpp \
+    src/twitch/sendqueue.cpp \
+    src/twitch/blockedusers.cpp \
+    src/util/multipatternmatcher.cpp \
+    src/twitch/ingestfilter.cpp \
+    src/messages/highlightengine.cpp \
+    src/messages/usermessagehistory.cpp \
+    src/messages/searchindex.cpp \
+    src/globalsearch.cpp \
+    src/widgets/searchwindow.cpp \
+    src/messages/messagefilter.cpp \
+    src/messages/textmeasurer.cpp \
+    src/messages/glyphadvances.cpp
 
 HEADERS  += \
     src/asyncexec.hpp \
@@ -157,7 +172,26 @@ HEADERS  += \
     src/util/distancebetweenpoints.hpp \
     src/messagefactory.hpp \
     src/widgets/basewidget.hpp \
-    src/completionmanager.hpp
+    src/completionmanager.hpp \
+    src/util/byteview.hpp \
+    src/twitch/rawircmessage.hpp \
+    src/twitch/twitchconnection.hpp \
+    src/util/boundedqueue.hpp \
+    src/util/ratelimiter.hpp \
+    src/twitch/readconnectionpool.hpp \
+    src/twitch/sendqueue.hpp \
+    src/twitch/blockedusers.hpp \
+    src/util/multipatternmatcher.hpp \
+    src/twitch/ingestfilter.hpp \
+    src/messages/highlightengine.hpp \
+    src/messages/usermessagehistory.hpp \
+    src/messages/searchindex.hpp \
+    src/globalsearch.hpp \
+    src/widgets/searchwindow.hpp \
+    src/messages/messagefilter.hpp \
+    src/messages/textmeasurer.hpp \
+    src/messages/glyphadvances.hpp \
+    src/util/rcupointer.hpp
 
 PRECOMPILED_HEADER =
 
@@ -30,8 +30,8 @@ Application::Application()
 
     this->windowManager.load();
 
-    this->ircManager.onPrivateMessage.connect([=](Communi::IrcPrivateMessage *message) {
-        QString channelName = message->target().mid(1);
+    this->ircManager.onPrivateMessage.connect([=](const twitch::RawIrcMessage &message) {
+        QString channelName = message.getChannelName();
 
         auto channel = this->channelManager.getChannel(channelName);
 
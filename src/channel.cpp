@@ -3,6 +3,7 @@
 #include "ircmanager.hpp"
 #include "logging/loggingmanager.hpp"
 #include "messages/message.hpp"
+#include "settingsmanager.hpp"
 #include "windowmanager.hpp"
 
 #include <QDebug>
@@ -20,22 +21,22 @@ namespace chatterino {
 
 Channel::Channel(WindowManager &_windowManager, EmoteManager &_emoteManager,
                  IrcManager &_ircManager, const QString &channelName, bool isSpecial)
-    : windowManager(_windowManager)
+    : name(channelName)
+    , windowManager(_windowManager)
     , emoteManager(_emoteManager)
     , ircManager(_ircManager)
-    , name(channelName)
+    , _clearEpoch(std::make_shared<std::atomic<int>>(0))
+    , _isSpecial(isSpecial)
     , bttvChannelEmotes(this->emoteManager.bttvChannels[channelName])
     , ffzChannelEmotes(this->emoteManager.ffzChannels[channelName])
     , _subLink("https://www.twitch.tv/" + name + "/subscribe?ref=in_chat_subscriber_link")
     , _channelLink("https://twitch.tv/" + name)
     , _popoutPlayerLink("https://player.twitch.tv/?channel=" + name)
-//    , _loggingChannel(logging::get(_name))
 {
     qDebug() << "Open channel:" << this->name;
 
-    if (!isSpecial) {
-        this->reloadChannelEmotes();
-    }
+    // the emotes are loaded once the channel is shown
+    _hiddenTime.start();
 }
 
 //
@@ -94,11 +95,46 @@ void Channel::addMessage(std::shared_ptr<Message> message)
 {
     std::shared_ptr<Message> deleted;
 
-    //    if (_loggingChannel.get() != nullptr) {
-    //        _loggingChannel->append(message);
-    //    }
+    // the log file is opened with the first message after logging was enabled, and closed
+    // with the first one after it was disabled
+    if (!_isSpecial && SettingsManager::getInstance().enableLogging.get()) {
+        if (_loggingChannel.get() == nullptr) {
+            _loggingChannel = logging::get(this->name);
+        }
+
+        if (_loggingChannel.get() != nullptr) {
+            _loggingChannel->append(message);
+        }
+    } else {
+        _loggingChannel.reset();
+    }
+
+    // messages shared with /mentions keep the epoch of the channel they were sent in
+    if (!message->hasClearEpoch()) {
+        message->setClearEpoch(_clearEpoch);
+    }
+
+    if (!message->getUserName().isEmpty()) {
+        _userMessages[message->getUserName()].push_back(message.get());
+    }
+
+    _searchIndex.addMessage(message);
 
     if (_messages.appendItem(message, deleted)) {
+        // messages leave in the order they came in, so it's the oldest one of its user
+        auto userMessages = _userMessages.find(deleted->getUserName());
+
+        if (userMessages != _userMessages.end() && !userMessages.value().empty() &&
+            userMessages.value().front() == deleted.get()) {
+            userMessages.value().pop_front();
+
+            if (userMessages.value().empty()) {
+                _userMessages.erase(userMessages);
+            }
+        }
+
+        _searchIndex.removeOldestMessage(deleted);
+
         messageRemovedFromStart(deleted);
     }
 
@@ -107,7 +143,100 @@ void Channel::addMessage(std::shared_ptr<Message> message)
     this->windowManager.repaintVisibleChatWidgets(this);
 }
 
+void Channel::disableUserMessages(const QString &userName)
+{
+    auto userMessages = _userMessages.find(userName);
+
+    if (userMessages == _userMessages.end()) {
+        return;
+    }
+
+    for (Message *message : userMessages.value()) {
+        message->setDisabled(true);
+    }
+
+    this->windowManager.repaintVisibleChatWidgets(this);
+}
+
+std::vector<Message *> Channel::search(const QString &text) const
+{
+    return _searchIndex.search(text);
+}
+
+void Channel::disableAllMessages()
+{
+    (*_clearEpoch)++;
+
+    this->windowManager.repaintVisibleChatWidgets(this);
+}
+
 // private methods
+void Channel::viewShown()
+{
+    _visibleViews++;
+
+    if (_hibernating) {
+        qDebug() << "[Channel] Waking up" << this->name;
+
+        _hibernating = false;
+    }
+
+    if (!_emotesLoaded && !_isSpecial) {
+        _emotesLoaded = true;
+
+        this->reloadChannelEmotes();
+    }
+}
+
+void Channel::viewHidden()
+{
+    _visibleViews--;
+
+    if (_visibleViews == 0) {
+        _hiddenTime.restart();
+    }
+}
+
+void Channel::hibernateIfIdle(qint64 idleMilliseconds)
+{
+    if (_isSpecial || _hibernating || _visibleViews > 0 ||
+        _hiddenTime.elapsed() < idleMilliseconds) {
+        return;
+    }
+
+    this->hibernate();
+}
+
+bool Channel::isHibernating() const
+{
+    return _hibernating;
+}
+
+void Channel::hibernate()
+{
+    qDebug() << "[Channel] Hibernating" << this->name;
+
+    _hibernating = true;
+
+    // hidden splits drop their laid out messages, nothing references the words after this
+    this->hibernating();
+
+    auto snapshot = _messages.getSnapshot();
+
+    for (std::size_t i = 0; i < snapshot.getLength(); i++) {
+        // highlighted messages are shown in /mentions as well
+        if (!snapshot[i]->getCanHighlightTab()) {
+            snapshot[i]->releaseWords();
+        }
+    }
+
+    if (_emotesLoaded) {
+        _emotesLoaded = false;
+
+        this->emoteManager.releaseChannelEmotes(this->name, this->roomID);
+    }
+}
+
 void Channel::reloadChannelEmotes()
 {
     printf("[Channel:%s] Reloading channel emotes\n", qPrintable(this->name));
@@ -5,13 +5,18 @@
 #include "logging/loggingchannel.hpp"
 #include "messages/lazyloadedimage.hpp"
 #include "messages/limitedqueue.hpp"
+#include "messages/searchindex.hpp"
 
+#include <QElapsedTimer>
+#include <QHash>
 #include <QMap>
 #include <QMutex>
 #include <QString>
 #include <QVector>
 #include <boost/signals2.hpp>
 
+#include <atomic>
+#include <deque>
 #include <memory>
 
 namespace chatterino {
@@ -31,6 +36,9 @@ public:
     boost::signals2::signal<void(messages::SharedMessage &)> messageRemovedFromStart;
     boost::signals2::signal<void(messages::SharedMessage &)> messageAppended;
 
+    // The channel is about to release the words of its messages, drop everything laid out
+    boost::signals2::signal<void()> hibernating;
+
     bool isEmpty() const;
     const QString &getSubLink() const;
     const QString &getChannelLink() const;
@@ -43,8 +51,29 @@ public:
 
     // methods
     void addMessage(messages::SharedMessage message);
+
+    // Timeouts and bans, only touches the messages of that user
+    void disableUserMessages(const QString &userName);
+
+    // /clear, doesn't touch any message
+    void disableAllMessages();
+
+    // Messages containing text (case insensitive), oldest first
+    std::vector<messages::Message *> search(const QString &text) const;
+
     void reloadChannelEmotes();
 
+    // Called by splits showing the channel when they're shown or hidden. The channel emotes are
+    // loaded once the channel is shown for the first time.
+    void viewShown();
+    void viewHidden();
+
+    // A channel that wasn't shown for a while hibernates: its messages are compacted back to their
+    // raw lines, its emote maps are cleared and its badge images are unloaded. All of it is
+    // restored lazily once the channel is shown again.
+    void hibernateIfIdle(qint64 idleMilliseconds);
+    bool isHibernating() const;
+
     void sendMessage(const QString &message);
 
     std::string roomID;
@@ -58,6 +87,22 @@ private:
     // variables
     messages::LimitedQueue<messages::SharedMessage> _messages;
 
+    // user name -> that user's messages which are still in _messages, oldest first
+    QHash<QString, std::deque<messages::Message *>> _userMessages;
+
+    // increased by disableAllMessages, see Message::setClearEpoch
+    std::shared_ptr<std::atomic<int>> _clearEpoch;
+
+    messages::SearchIndex _searchIndex;
+
+    const bool _isSpecial;
+    int _visibleViews = 0;
+    QElapsedTimer _hiddenTime;
+    bool _hibernating = false;
+    bool _emotesLoaded = false;
+
+    void hibernate();
+
 public:
     const EmoteManager::EmoteMap &bttvChannelEmotes;
     const EmoteManager::EmoteMap &ffzChannelEmotes;
@@ -71,7 +116,7 @@ private:
     int _streamViewerCount;
     QString _streamStatus;
     QString _streamGame;
-    // std::shared_ptr<logging::Channel> _loggingChannel;
+    std::shared_ptr<logging::Channel> _loggingChannel;
 };
 
 }  // namespace chatterino
@@ -1,5 +1,6 @@
 #include "channelmanager.hpp"
 #include "ircmanager.hpp"
+#include "settingsmanager.hpp"
 
 namespace chatterino {
 
@@ -11,7 +12,38 @@ ChannelManager::ChannelManager(WindowManager &_windowManager, EmoteManager &_emo
     , whispersChannel(new Channel(_windowManager, _emoteManager, _ircManager, "/whispers", true))
     , mentionsChannel(new Channel(_windowManager, _emoteManager, _ircManager, "/mentions", true))
     , emptyChannel(new Channel(_windowManager, _emoteManager, _ircManager, "", true))
+    , userMessageHistory(SettingsManager::getInstance().userHistoryMessageCount.get(),
+                         SettingsManager::getInstance().userHistoryUserCount.get())
 {
+    auto &settings = SettingsManager::getInstance();
+
+    auto updateLimits = [this](const auto &) {
+        auto &settings = SettingsManager::getInstance();
+
+        this->userMessageHistory.setLimits(settings.userHistoryMessageCount.get(),
+                                           settings.userHistoryUserCount.get());
+    };
+
+    settings.userHistoryMessageCount.valueChanged.connect(updateLimits);
+    settings.userHistoryUserCount.valueChanged.connect(updateLimits);
+
+    this->hibernationTimer.setInterval(60 * 1000);
+    QObject::connect(&this->hibernationTimer, &QTimer::timeout,
+                     [this] { this->hibernateIdleChannels(); });
+    this->hibernationTimer.start();
+}
+
+void ChannelManager::hibernateIdleChannels()
+{
+    int minutes = SettingsManager::getInstance().hibernateChannelsAfter.get();
+
+    if (minutes <= 0) {
+        return;
+    }
+
+    for (const std::shared_ptr<Channel> &channel : this->getItems()) {
+        channel->hibernateIfIdle(minutes * 60 * 1000);
+    }
 }
 
 const std::vector<std::shared_ptr<Channel>> ChannelManager::getItems()
@@ -2,6 +2,9 @@
 
 #include "channel.hpp"
 #include "channeldata.hpp"
+#include "messages/usermessagehistory.hpp"
+
+#include <QTimer>
 
 #include <map>
 
@@ -34,12 +37,20 @@ public:
     const std::shared_ptr<Channel> mentionsChannel;
     const std::shared_ptr<Channel> emptyChannel;
 
+    // Recent messages of every user across all channels, filled as messages are received
+    messages::UserMessageHistory userMessageHistory;
+
 private:
     std::map<std::string, std::string> usernameToID;
     std::map<std::string, ChannelData> channelDatas;
 
     QMutex channelsMutex;
     QMap<QString, std::tuple<std::shared_ptr<Channel>, int>> channels;
+
+    // checks for channels to hibernate, see Channel::hibernateIfIdle
+    QTimer hibernationTimer;
+
+    void hibernateIdleChannels();
 };
 
 }  // namespace chatterino
@@ -95,6 +95,16 @@ void ColorScheme::setColors(double hue, double multiplier)
     ChatHeaderBorder = getColor(0, 0.1, 0.85);
     ChatInputBackground = getColor(0, 0.1, 0.95);
     ChatInputBorder = getColor(0, 0.1, 0.9);
+    ChatBackgroundHighlighted = lightTheme ? QColor(255, 220, 220) : QColor(110, 40, 40);
+
+    // boxes drawn over the chat, they stand out from the chat background
+    TooltipBackground = lightTheme ? QColor(64, 64, 64) : QColor(224, 224, 224);
+    TooltipText = lightTheme ? QColor(255, 255, 255) : QColor(0, 0, 0);
+
+    // scrollbar markers: highlights, search results, other
+    HighlightColors[0] = QColor(255, 64, 64);
+    HighlightColors[1] = QColor(255, 200, 0);
+    HighlightColors[2] = getColor(hue, 0.5, 0.5);
 
     ScrollbarBG = ChatBackground;
 
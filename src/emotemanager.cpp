@@ -125,6 +125,14 @@ void EmoteManager::reloadFFZChannelEmotes(const QString &channelName)
     });
 }
 
+void EmoteManager::releaseChannelEmotes(const QString &channelName, const std::string &roomID)
+{
+    this->bttvChannels[channelName].clear();
+    this->ffzChannels[channelName].clear();
+
+    this->resources.unloadChannelBadges(roomID);
+}
+
 ConcurrentMap<QString, twitch::EmoteValue *> &EmoteManager::getTwitchEmotes()
 {
     return _twitchEmotes;
@@ -44,6 +44,10 @@ public:
     void reloadBTTVChannelEmotes(const QString &channelName);
     void reloadFFZChannelEmotes(const QString &channelName);
 
+    // Forgets the channel's BTTV and FFZ emotes and unloads its badge images, for hibernating
+    // channels. The emote codes are kept for completion.
+    void releaseChannelEmotes(const QString &channelName, const std::string &roomID);
+
     ConcurrentMap<QString, twitch::EmoteValue *> &getTwitchEmotes();
     EmoteMap &getFFZEmotes();
     EmoteMap &getChatterinoEmotes();
@@ -10,11 +10,34 @@ FontManager::FontManager()
     , currentFont(this->currentFontFamily.getValue().c_str(), currentFontSize.getValue())
 {
     this->currentFontFamily.getValueChangedSignal().connect([this](const std::string &newValue) {
-        this->currentFont.setFamily(newValue.c_str());  //
+        this->currentFont.setFamily(newValue.c_str());
+        this->incGeneration();
     });
     this->currentFontSize.getValueChangedSignal().connect([this](const int &newValue) {
-        this->currentFont.setSize(newValue);  //
+        this->currentFont.setSize(newValue);
+        this->incGeneration();
     });
+
+    this->updateSnapshot();
+}
+
+void FontManager::incGeneration()
+{
+    this->generation++;
+
+    this->updateSnapshot();
+}
+
+void FontManager::updateSnapshot()
+{
+    auto newSnapshot = std::make_shared<Snapshot>();
+    newSnapshot->generation = this->generation;
+
+    for (int type = Small; type <= VeryLarge; type++) {
+        newSnapshot->fonts.push_back(this->getFont(static_cast<Type>(type)));
+    }
+
+    this->snapshot = newSnapshot;
 }
 
 QFont &FontManager::getFont(Type type)
@@ -4,6 +4,9 @@
 #include <QFontMetrics>
 #include <pajlada/settings/setting.hpp>
 
+#include <memory>
+#include <vector>
+
 namespace chatterino {
 
 class FontManager
@@ -18,6 +21,13 @@ public:
         VeryLarge,
     };
 
+    // Copies of the fonts of one generation, indexed by Type. QFont is only reentrant, so text
+    // is measured off the GUI thread with copies like these, see messages::TextMeasurer.
+    struct Snapshot {
+        int generation;
+        std::vector<QFont> fonts;
+    };
+
     // FontManager is initialized only once, on first use
     static FontManager &getInstance()
     {
@@ -34,9 +44,12 @@ public:
         return this->generation;
     }
 
-    void incGeneration()
+    void incGeneration();
+
+    // Must be called from the GUI thread, the snapshot itself can be used from any thread
+    std::shared_ptr<const Snapshot> getSnapshot() const
     {
-        this->generation++;
+        return this->snapshot;
     }
 
     pajlada::Settings::Setting<std::string> currentFontFamily;
@@ -122,6 +135,10 @@ private:
     Font currentFont;
 
     int generation = 0;
+
+    std::shared_ptr<const Snapshot> snapshot;
+
+    void updateSnapshot();
 };
 
 }  // namespace chatterino
@@ -0,0 +1,278 @@
+#include "globalsearch.hpp"
+#include "asyncexec.hpp"
+#include "channel.hpp"
+#include "channelmanager.hpp"
+#include "logging/loggingmanager.hpp"
+#include "messages/message.hpp"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+
+namespace chatterino {
+
+namespace {
+
+// Once this many results are found the search stops
+const int maxResults = 1000;
+
+const int deliverInterval = 100;
+
+// "<channel>-yyyy-MM-dd.log"
+const int logDateLength = 10;
+
+// "[HH:mm:ss] user: text"
+const int logTimeLength = 10;
+
+}  // namespace
+
+bool GlobalSearch::parseLogLine(const QString &line, const QDate &date, GlobalSearchResult &result)
+{
+    // "# Start logging at ..."
+    if (!line.startsWith('[')) {
+        return false;
+    }
+
+    int separator = line.indexOf(": ", logTimeLength);
+
+    if (separator == -1) {
+        return false;
+    }
+
+    result.userName = line.mid(logTimeLength + 1, separator - logTimeLength - 1);
+    result.text = line.mid(separator + 2);
+    result.time = QDateTime(date, QTime::fromString(line.mid(1, 8), "HH:mm:ss"));
+    result.fromLog = true;
+
+    return true;
+}
+
+#ifndef QT_NO_DEBUG
+void GlobalSearch::checkLogFormat()
+{
+    QDateTime time(QDate(2017, 1, 1), QTime(12, 34, 56));
+    QString line = logging::Channel::formatLine(time, "user", "text: with a colon").trimmed();
+
+    GlobalSearchResult result;
+
+    Q_ASSERT_X(parseLogLine(line, time.date(), result) && result.userName == "user" &&
+                   result.text == "text: with a colon" && result.time == time,
+               "GlobalSearch", "log lines written by logging::Channel can't be searched");
+}
+#endif
+
+GlobalSearch::Search::Search(const QString &_text)
+    : text(_text)
+    , cancelled(false)
+    , remainingTasks(0)
+{
+}
+
+bool GlobalSearch::Search::addResults(std::vector<GlobalSearchResult> &results)
+{
+    QMutexLocker locker(&this->mutex);
+
+    for (GlobalSearchResult &result : results) {
+        if (this->resultCount >= maxResults) {
+            this->cancelled = true;
+            break;
+        }
+
+        this->pendingResults.push_back(std::move(result));
+        this->resultCount++;
+    }
+
+    results.clear();
+
+    return !this->cancelled;
+}
+
+GlobalSearch::GlobalSearch(ChannelManager &_channelManager)
+    : channelManager(_channelManager)
+{
+    this->deliverTimer.setInterval(deliverInterval);
+
+    QObject::connect(&this->deliverTimer, &QTimer::timeout, this, &GlobalSearch::deliverResults);
+
+#ifndef QT_NO_DEBUG
+    checkLogFormat();
+#endif
+}
+
+GlobalSearch::~GlobalSearch()
+{
+    this->cancel();
+}
+
+void GlobalSearch::start(const QString &text, bool includeLogs)
+{
+    this->cancel();
+
+    if (text.isEmpty()) {
+        return;
+    }
+
+    auto search = std::make_shared<Search>(text);
+    this->currentSearch = search;
+
+    std::vector<std::shared_ptr<Channel>> channels = this->channelManager.getItems();
+    channels.push_back(this->channelManager.whispersChannel);
+
+    for (const std::shared_ptr<Channel> &channel : channels) {
+        // copy the message pointers here, the channel keeps appending to the snapshot's vector
+        auto snapshot = channel->getMessageSnapshot();
+
+        auto channelMessages = std::make_shared<std::vector<messages::SharedMessage>>();
+        channelMessages->reserve(snapshot.getLength());
+
+        for (size_t i = 0; i < snapshot.getLength(); i++) {
+            channelMessages->push_back(snapshot[i]);
+        }
+
+        QString channelName = channel->name;
+
+        search->remainingTasks++;
+
+        // async_exec is a macro, the capture list's commas can't be inside of it
+        auto task = [search, channelMessages, channelName] {
+            std::vector<GlobalSearchResult> results;
+
+            for (const messages::SharedMessage &message : *channelMessages) {
+                if (search->cancelled) {
+                    break;
+                }
+
+                if (!message->text.contains(search->text, Qt::CaseInsensitive)) {
+                    continue;
+                }
+
+                GlobalSearchResult result;
+                result.channelName = channelName;
+                result.userName = message->getUserName();
+                result.text = message->text;
+                result.time = QDateTime::fromMSecsSinceEpoch(
+                    std::chrono::duration_cast<std::chrono::milliseconds>(
+                        message->getParseTime().time_since_epoch())
+                        .count());
+
+                results.push_back(result);
+            }
+
+            search->addResults(results);
+            search->remainingTasks--;
+        };
+
+        async_exec(task);
+    }
+
+    if (includeLogs) {
+        QDir logDirectory(logging::getChannelsDirectory());
+
+        for (const QFileInfo &file : logDirectory.entryInfoList({"*.log"}, QDir::Files)) {
+            search->remainingTasks++;
+
+            QString filePath = file.absoluteFilePath();
+
+            auto task = [search, filePath] {
+                searchLogFile(search, filePath);
+                search->remainingTasks--;
+            };
+
+            async_exec(task);
+        }
+    }
+
+    this->deliverTimer.start();
+}
+
+void GlobalSearch::cancel()
+{
+    if (!this->currentSearch) {
+        return;
+    }
+
+    // running tasks finish on their own, nobody collects their results
+    this->currentSearch->cancelled = true;
+    this->currentSearch.reset();
+
+    this->deliverTimer.stop();
+}
+
+bool GlobalSearch::isRunning() const
+{
+    return this->currentSearch != nullptr;
+}
+
+void GlobalSearch::deliverResults()
+{
+    if (!this->currentSearch) {
+        return;
+    }
+
+    // read before taking the results, so nothing added by the last task is missed
+    bool done = this->currentSearch->remainingTasks == 0;
+
+    std::vector<GlobalSearchResult> results;
+
+    {
+        QMutexLocker locker(&this->currentSearch->mutex);
+        results.swap(this->currentSearch->pendingResults);
+    }
+
+    if (!results.empty()) {
+        this->resultsFound(results);
+    }
+
+    if (done) {
+        this->currentSearch.reset();
+        this->deliverTimer.stop();
+
+        this->finished();
+    }
+}
+
+void GlobalSearch::searchLogFile(std::shared_ptr<Search> search, const QString &filePath)
+{
+    QFile file(filePath);
+
+    if (!file.open(QIODevice::ReadOnly)) {
+        return;
+    }
+
+    QString baseName = QFileInfo(filePath).completeBaseName();
+    QDate date = QDate::fromString(baseName.right(logDateLength), "yyyy-MM-dd");
+    QString channelName = baseName.left(baseName.length() - logDateLength - 1);
+
+    std::vector<GlobalSearchResult> results;
+
+    while (!file.atEnd() && !search->cancelled) {
+        QString line = QString::fromUtf8(file.readLine()).trimmed();
+
+        if (!line.contains(search->text, Qt::CaseInsensitive)) {
+            continue;
+        }
+
+        GlobalSearchResult result;
+        result.channelName = channelName;
+
+        if (!parseLogLine(line, date, result)) {
+            continue;
+        }
+
+        // the search text may have matched the name only
+        if (!result.text.contains(search->text, Qt::CaseInsensitive)) {
+            continue;
+        }
+
+        results.push_back(result);
+
+        // hand them over in chunks, big logs take a while
+        if (results.size() >= 100 && !search->addResults(results)) {
+            return;
+        }
+    }
+
+    search->addResults(results);
+}
+
+}  // namespace chatterino
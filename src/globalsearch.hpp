@@ -0,0 +1,89 @@
+#pragma once
+
+#include <QDateTime>
+#include <QMutex>
+#include <QObject>
+#include <QString>
+#include <QTimer>
+#include <boost/signals2.hpp>
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace chatterino {
+
+class ChannelManager;
+
+struct GlobalSearchResult {
+    QString channelName;
+    QString userName;
+    QString text;
+    QDateTime time;
+
+    // found in a log file instead of an open channel
+    bool fromLog = false;
+};
+
+// GlobalSearch runs a query over the messages of all open channels, and optionally over the log
+// files, on the thread pool. Every channel and every log file is searched by its own task, results
+// are handed to the GUI thread as they're found, so they stream in while the rest is searched.
+//
+// Starting a new search cancels the running one; its tasks stop at the next message or line and
+// their results are dropped.
+class GlobalSearch : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit GlobalSearch(ChannelManager &_channelManager);
+    ~GlobalSearch();
+
+    void start(const QString &text, bool includeLogs);
+    void cancel();
+
+    bool isRunning() const;
+
+    // Invoked in the GUI thread, in no particular order
+    boost::signals2::signal<void(const std::vector<GlobalSearchResult> &)> resultsFound;
+    boost::signals2::signal<void()> finished;
+
+private:
+    // Shared with the tasks, which never touch the GlobalSearch itself
+    struct Search {
+        QString text;
+
+        std::atomic<bool> cancelled;
+        std::atomic<int> remainingTasks;
+
+        QMutex mutex;
+        std::vector<GlobalSearchResult> pendingResults;
+        int resultCount = 0;
+
+        Search(const QString &_text);
+
+        // Returns false once there are enough results
+        bool addResults(std::vector<GlobalSearchResult> &results);
+    };
+
+    ChannelManager &channelManager;
+
+    std::shared_ptr<Search> currentSearch;
+
+    // results are collected from the tasks periodically, instead of every task posting to us
+    QTimer deliverTimer;
+
+    void deliverResults();
+
+    static void searchLogFile(std::shared_ptr<Search> search, const QString &filePath);
+
+    // Reads a line written by logging::Channel, returns false for the other lines of a log
+    static bool parseLogLine(const QString &line, const QDate &date, GlobalSearchResult &result);
+
+#ifndef QT_NO_DEBUG
+    // Asserts that a line written by logging::Channel is found by the log search
+    static void checkLogFormat();
+#endif
+};
+
+}  // namespace chatterino
@@ -3,8 +3,12 @@
 #include "asyncexec.hpp"
 #include "channel.hpp"
 #include "channelmanager.hpp"
+#include "colorscheme.hpp"
 #include "emotemanager.hpp"
 #include "messages/messageparseargs.hpp"
+#include "settingsmanager.hpp"
+#include "twitch/sendqueue.hpp"
+#include "twitch/twitchconnection.hpp"
 #include "twitch/twitchmessagebuilder.hpp"
 #include "twitch/twitchparsemessage.hpp"
 #include "twitch/twitchuser.hpp"
@@ -13,11 +17,6 @@
 
 #include <irccommand.h>
 #include <ircconnection.h>
-#include <QJsonArray>
-#include <QJsonDocument>
-#include <QJsonObject>
-#include <QNetworkReply>
-#include <QNetworkRequest>
 
 #include <future>
 
@@ -25,6 +24,22 @@ using namespace chatterino::messages;
 
 namespace chatterino {
 
+namespace {
+
+// Once this many messages are waiting for the GUI thread, we stop reading from the sockets
+const size_t incomingQueueCapacity = 10000;
+
+// Number of queued messages handled per event loop iteration, so painting isn't starved
+const size_t incomingBatchSize = 250;
+
+// Connections live in the I/O thread and must be deleted there
+void deleteConnection(QObject *connection)
+{
+    connection->deleteLater();
+}
+
+}  // namespace
+
 const QString IrcManager::defaultClientId("7ue61iz46fz11y3cugd0l3tawb4taal");
 
 IrcManager::IrcManager(ChannelManager &_channelManager, Resources &_resources,
@@ -34,7 +49,35 @@ IrcManager::IrcManager(ChannelManager &_channelManager, Resources &_resources,
     , emoteManager(_emoteManager)
     , windowManager(_windowManager)
     , _account(AccountManager::getInstance().getTwitchUser())
+    , incomingMessages(incomingQueueCapacity)
+    , incomingMessagesScheduled(false)
+    , readingPaused(false)
+    , ingestFilter(this->blockedUsers)
 {
+    auto &settings = SettingsManager::getInstance();
+
+    this->updateIgnoreRules();
+    this->updateHighlightRules();
+
+    settings.ignoredPhrases.valueChanged.connect(
+        [this](const auto &) { this->updateIgnoreRules(); });
+    settings.ignoredEmotes.valueChanged.connect(
+        [this](const auto &) { this->updateIgnoreRules(); });
+    settings.highlightPhrases.valueChanged.connect(
+        [this](const auto &) { this->updateHighlightRules(); });
+    settings.highlightRegexes.valueChanged.connect(
+        [this](const auto &) { this->updateHighlightRules(); });
+
+    this->ioThread.setObjectName("IRC I/O");
+    this->ioThread.start();
+}
+
+IrcManager::~IrcManager()
+{
+    this->disconnect();
+
+    this->ioThread.quit();
+    this->ioThread.wait();
 }
 
 const twitch::TwitchUser &IrcManager::getUser() const
@@ -45,6 +88,8 @@ const twitch::TwitchUser &IrcManager::getUser() const
 void IrcManager::setUser(const twitch::TwitchUser &account)
 {
     _account = account;
+
+    this->updateHighlightRules();
 }
 
 void IrcManager::connect()
@@ -54,106 +99,78 @@ void IrcManager::connect()
     async_exec([this] { beginConnecting(); });
 }
 
-Communi::IrcConnection *IrcManager::createConnection(bool doRead)
+twitch::TwitchConnection *IrcManager::createWriteConnection()
 {
-    Communi::IrcConnection *connection = new Communi::IrcConnection;
-
-    if (doRead) {
-        QObject::connect(connection, &Communi::IrcConnection::messageReceived, this,
-                         &IrcManager::messageReceived);
-        QObject::connect(connection, &Communi::IrcConnection::privateMessageReceived, this,
-                         &IrcManager::privateMessageReceived);
-    }
-
-    QString username = _account.getUserName();
-    QString oauthClient = _account.getOAuthClient();
-    QString oauthToken = _account.getOAuthToken();
+    auto &settings = SettingsManager::getInstance();
 
-    connection->setUserName(username);
-    connection->setNickName(username);
-    connection->setRealName(username);
+    QString password;
 
     if (!_account.isAnon()) {
-        connection->setPassword(oauthToken);
-
-        this->refreshIgnoredUsers(username, oauthClient, oauthToken);
+        password = _account.getOAuthToken();
     }
 
-    if (doRead) {
-        connection->sendCommand(
-            Communi::IrcCommand::createCapability("REQ", "twitch.tv/membership"));
-        connection->sendCommand(Communi::IrcCommand::createCapability("REQ", "twitch.tv/commands"));
-        connection->sendCommand(Communi::IrcCommand::createCapability("REQ", "twitch.tv/tags"));
-    }
-
-    connection->setHost("irc.chat.twitch.tv");
-    connection->setPort(6667);
-
-    return connection;
+    // supervises itself like the read connections: keepalive PINGs and jittered backoff
+    return new twitch::TwitchConnection(
+        QString::fromStdString(settings.ircServerHost.getValue()),
+        static_cast<quint16>(settings.ircServerPort.getValue()), _account.getUserName(),
+        password);
 }
 
-void IrcManager::refreshIgnoredUsers(const QString &username, const QString &oauthClient,
-                                     const QString &oauthToken)
+twitch::ReadConnectionPool *IrcManager::createReadConnections()
 {
-    QString nextLink = "https://api.twitch.tv/kraken/users/" + username + "/blocks?limit=" + 100 +
-                       "&client_id=" + oauthClient;
-
-    QNetworkAccessManager *manager = new QNetworkAccessManager();
-    QNetworkRequest req(QUrl(nextLink + "&oauth_token=" + oauthToken));
-    QNetworkReply *reply = manager->get(req);
-
-    QObject::connect(reply, &QNetworkReply::finished, [=] {
-        _twitchBlockedUsersMutex.lock();
-        _twitchBlockedUsers.clear();
-        _twitchBlockedUsersMutex.unlock();
+    auto &settings = SettingsManager::getInstance();
 
-        QByteArray data = reply->readAll();
-        QJsonDocument jsonDoc(QJsonDocument::fromJson(data));
-        QJsonObject root = jsonDoc.object();
+    QString password;
 
-        // nextLink =
-        // root.value("_links").toObject().value("next").toString();
+    if (!_account.isAnon()) {
+        password = _account.getOAuthToken();
+    }
 
-        auto blocks = root.value("blocks").toArray();
+    auto pool = new twitch::ReadConnectionPool(
+        QString::fromStdString(settings.ircServerHost.getValue()),
+        static_cast<quint16>(settings.ircServerPort.getValue()), _account.getUserName(), password,
+        settings.ircReadConnectionCount.getValue());
 
-        _twitchBlockedUsersMutex.lock();
-        for (QJsonValue block : blocks) {
-            QJsonObject user = block.toObject().value("user").toObject();
-            // display_name
-            _twitchBlockedUsers.insert(user.value("name").toString().toLower(), true);
-        }
-        _twitchBlockedUsersMutex.unlock();
+    pool->messageReceived.connect(
+        [this](twitch::TwitchConnection *connection, const twitch::RawIrcMessage &message) {
+            this->enqueueIncomingMessage(connection, message);
+        });
 
-        manager->deleteLater();
-    });
+    return pool;
 }
 
 void IrcManager::beginConnecting()
 {
     uint32_t generation = ++this->connectionGeneration;
 
-    Communi::IrcConnection *_writeConnection = this->createConnection(false);
-    Communi::IrcConnection *_readConnection = this->createConnection(true);
+    // the block list is fetched in the GUI thread, where its network access manager lives
+    QMetaObject::invokeMethod(this, "refreshIgnoredUsers", Qt::QueuedConnection);
+
+    auto _sendQueue = new twitch::SendQueue(this->createWriteConnection());
+    twitch::ReadConnectionPool *_readConnections = this->createReadConnections();
 
     std::lock_guard<std::mutex> locker(this->connectionMutex);
 
     if (generation == this->connectionGeneration) {
-        this->writeConnection = std::shared_ptr<Communi::IrcConnection>(_writeConnection);
-        this->readConnection = std::shared_ptr<Communi::IrcConnection>(_readConnection);
+        this->sendQueue = std::shared_ptr<twitch::SendQueue>(_sendQueue, deleteConnection);
+        this->readConnections =
+            std::shared_ptr<twitch::ReadConnectionPool>(_readConnections, deleteConnection);
+
+        this->sendQueue->moveToThread(&this->ioThread);
+        this->readConnections->moveToThread(&this->ioThread);
 
-        this->writeConnection->moveToThread(QCoreApplication::instance()->thread());
-        this->readConnection->moveToThread(QCoreApplication::instance()->thread());
+        // the connections live in the I/O thread now, their sockets must be created there
+        QMetaObject::invokeMethod(this->sendQueue.get(), "open", Qt::QueuedConnection);
+        QMetaObject::invokeMethod(this->readConnections.get(), "open", Qt::QueuedConnection);
 
+        // the pool batches the joins once its connections are up
         for (auto &channel : this->channelManager.getItems()) {
-            this->writeConnection->sendRaw("JOIN #" + channel->name);
-            this->readConnection->sendRaw("JOIN #" + channel->name);
+            QMetaObject::invokeMethod(this->readConnections.get(), "joinChannel",
+                                      Qt::QueuedConnection, Q_ARG(QString, channel->name));
         }
-
-        this->writeConnection->open();
-        this->readConnection->open();
     } else {
-        delete _writeConnection;
-        delete _readConnection;
+        delete _sendQueue;
+        delete _readConnections;
     }
 }
 
@@ -161,24 +178,79 @@ void IrcManager::disconnect()
 {
     this->connectionMutex.lock();
 
-    auto _readConnection = this->readConnection;
-    auto _writeConnection = this->writeConnection;
+    auto _readConnections = this->readConnections;
+    auto _sendQueue = this->sendQueue;
+
+    this->readConnections.reset();
+    this->sendQueue.reset();
 
-    this->readConnection.reset();
-    this->writeConnection.reset();
+    this->readingPaused = false;
 
     this->connectionMutex.unlock();
 }
 
+void IrcManager::enqueueIncomingMessage(twitch::TwitchConnection *connection,
+                                        const twitch::RawIrcMessage &message)
+{
+    // called in the I/O thread
+    if (this->ingestFilter.shouldDrop(message)) {
+        return;
+    }
+
+    if (!this->incomingMessages.push(message)) {
+        // the GUI thread can't keep up, processIncomingMessages resumes reading
+        this->readingPaused = true;
+        connection->pauseReading();
+    }
+
+    if (!this->incomingMessagesScheduled.exchange(true)) {
+        QMetaObject::invokeMethod(this, "processIncomingMessages", Qt::QueuedConnection);
+    }
+}
+
+void IrcManager::processIncomingMessages()
+{
+    this->incomingMessagesScheduled = false;
+
+    std::vector<twitch::RawIrcMessage> messages;
+    messages.reserve(incomingBatchSize);
+
+    size_t remaining = this->incomingMessages.popBatch(messages, incomingBatchSize);
+
+    for (const twitch::RawIrcMessage &message : messages) {
+        this->messageReceived(message);
+    }
+
+    if (remaining > 0 && !this->incomingMessagesScheduled.exchange(true)) {
+        // handle the rest in the next event loop iteration
+        QMetaObject::invokeMethod(this, "processIncomingMessages", Qt::QueuedConnection);
+    }
+
+    if (remaining < this->incomingMessages.getCapacity() / 2 &&
+        this->readingPaused.exchange(false)) {
+        std::lock_guard<std::mutex> locker(this->connectionMutex);
+
+        if (this->readConnections) {
+            QMetaObject::invokeMethod(this->readConnections.get(), "resumeReading",
+                                      Qt::QueuedConnection);
+        }
+    }
+}
+
 void IrcManager::sendMessage(const QString &channelName, const QString &message)
 {
-    this->connectionMutex.lock();
+    std::shared_ptr<twitch::SendQueue> _sendQueue;
 
-    if (this->writeConnection) {
-        this->writeConnection->sendRaw("PRIVMSG #" + channelName + " :" + message);
+    {
+        std::lock_guard<std::mutex> locker(this->connectionMutex);
+        _sendQueue = this->sendQueue;
     }
 
-    this->connectionMutex.unlock();
+    // the send queue paces the messages in the I/O thread, we never wait for it
+    if (_sendQueue) {
+        QMetaObject::invokeMethod(_sendQueue.get(), "sendMessage", Qt::QueuedConnection,
+                                  Q_ARG(QString, channelName), Q_ARG(QString, message));
+    }
 
     // DEBUGGING
     /*
@@ -208,9 +280,9 @@ void IrcManager::joinChannel(const QString &channelName)
 {
     this->connectionMutex.lock();
 
-    if (this->readConnection && this->writeConnection) {
-        this->readConnection->sendRaw("JOIN #" + channelName);
-        this->writeConnection->sendRaw("JOIN #" + channelName);
+    if (this->readConnections) {
+        QMetaObject::invokeMethod(this->readConnections.get(), "joinChannel",
+                                  Qt::QueuedConnection, Q_ARG(QString, channelName));
     }
 
     this->connectionMutex.unlock();
@@ -220,18 +292,48 @@ void IrcManager::partChannel(const QString &channelName)
 {
     this->connectionMutex.lock();
 
-    if (this->readConnection && this->writeConnection) {
-        this->readConnection->sendRaw("PART #" + channelName);
-        this->writeConnection->sendRaw("PART #" + channelName);
+    if (this->readConnections) {
+        QMetaObject::invokeMethod(this->readConnections.get(), "partChannel",
+                                  Qt::QueuedConnection, Q_ARG(QString, channelName));
     }
 
     this->connectionMutex.unlock();
 }
 
-void IrcManager::privateMessageReceived(Communi::IrcPrivateMessage *message)
+int IrcManager::getSendQueueDepth()
+{
+    std::lock_guard<std::mutex> locker(this->connectionMutex);
+
+    return this->sendQueue ? this->sendQueue->getDepth() : 0;
+}
+
+qint64 IrcManager::getSendQueueWaitTime()
+{
+    std::lock_guard<std::mutex> locker(this->connectionMutex);
+
+    return this->sendQueue ? this->sendQueue->getLastWaitTime() : 0;
+}
+
+std::vector<twitch::ReadConnectionStatistics> IrcManager::getReadConnectionStatistics()
+{
+    std::lock_guard<std::mutex> locker(this->connectionMutex);
+
+    if (!this->readConnections) {
+        return {};
+    }
+
+    return this->readConnections->getStatistics();
+}
+
+std::vector<twitch::IngestFilter::RuleStatistics> IrcManager::getIgnoreStatistics() const
+{
+    return this->ingestFilter.getStatistics();
+}
+
+void IrcManager::privateMessageReceived(const twitch::RawIrcMessage &message)
 {
     this->onPrivateMessage.invoke(message);
-    auto c = this->channelManager.getChannel(message->target().mid(1));
+    auto c = this->channelManager.getChannel(message.getChannelName());
 
     if (!c) {
         return;
@@ -240,21 +342,54 @@ void IrcManager::privateMessageReceived(Communi::IrcPrivateMessage *message)
     messages::MessageParseArgs args;
 
     twitch::TwitchMessageBuilder builder(c.get(), this->resources, this->emoteManager,
-                                         this->windowManager, message, args);
+                                         this->windowManager, this->highlightEngine, message,
+                                         args);
 
-    c->addMessage(builder.parse());
-}
+    // Routing, highlights, filters and search only need the metadata. The words are built once
+    // a split lays the message out, most messages of background channels never are.
+    SharedMessage builtMessage = builder.parseWithoutWords();
 
-void IrcManager::messageReceived(Communi::IrcMessage *message)
-{
-    if (message->type() == Communi::IrcMessage::Type::Private) {
-        // We already have a handler for private messages
-        return;
+    // a copy of just this line, the views into the receive buffer would keep all of it alive
+    QByteArray line = message.getLine().toByteArray();
+    std::weak_ptr<Channel> weakChannel = c;
+
+    builtMessage->setWordBuilder([this, line, weakChannel, args](const Message &lazyMessage) {
+        twitch::RawIrcMessage ircMessage;
+        twitch::RawIrcMessage::parse(line, ircMessage);
+
+        // the message can outlive its channel in /mentions and the user popup
+        std::shared_ptr<Channel> channel = weakChannel.lock();
+
+        if (!channel) {
+            channel = this->channelManager.emptyChannel;
+        }
+
+        twitch::TwitchMessageBuilder wordBuilder(channel.get(), this->resources,
+                                                 this->emoteManager, this->windowManager,
+                                                 this->highlightEngine, ircMessage, args);
+
+        return wordBuilder.parseWords(
+            std::chrono::system_clock::to_time_t(lazyMessage.getParseTime()));
+    });
+
+    c->addMessage(builtMessage);
+
+    this->channelManager.userMessageHistory.addMessage(builder.userName, c->name, builtMessage);
+
+    // the highlight engine stops at the first matching rule, so a message is routed once no
+    // matter how many rules it matches
+    if (builtMessage->getCanHighlightTab()) {
+        this->channelManager.mentionsChannel->addMessage(builtMessage);
     }
+}
 
-    const QString &command = message->command();
+void IrcManager::messageReceived(const twitch::RawIrcMessage &message)
+{
+    util::ByteView command = message.getCommand();
 
-    if (command == "ROOMSTATE") {
+    if (command == "PRIVMSG") {
+        this->privateMessageReceived(message);
+    } else if (command == "ROOMSTATE") {
         this->handleRoomStateMessage(message);
     } else if (command == "CLEARCHAT") {
         this->handleClearChatMessage(message);
@@ -267,110 +402,129 @@ void IrcManager::messageReceived(Communi::IrcMessage *message)
     }
 }
 
-void IrcManager::handleRoomStateMessage(Communi::IrcMessage *message)
+void IrcManager::handleRoomStateMessage(const twitch::RawIrcMessage &message)
 {
-    const auto &tags = message->tags();
-
-    auto iterator = tags.find("room-id");
+    util::ByteView roomIDTag = message.getRawTag("room-id");
 
-    if (iterator != tags.end()) {
-        std::string roomID = iterator.value().toString().toStdString();
+    if (!roomIDTag.isEmpty()) {
+        std::string roomID = roomIDTag.toByteArray().toStdString();
 
         this->resources.loadChannelData(roomID);
     }
 }
 
-void IrcManager::handleClearChatMessage(Communi::IrcMessage *message)
+void IrcManager::handleClearChatMessage(const twitch::RawIrcMessage &message)
 {
-    // do nothing
+    auto c = this->channelManager.getChannel(message.getChannelName());
+
+    if (!c) {
+        return;
+    }
+
+    QColor systemMessageColor = this->windowManager.colorScheme.SystemMessageColor;
+    QString text;
+
+    if (message.getParameterCount() < 2) {
+        // CLEARCHAT #channel
+        c->disableAllMessages();
+
+        text = "Chat has been cleared by a moderator.";
+    } else {
+        // CLEARCHAT #channel :user
+        QString userName = message.getParameter(1).toString();
+
+        c->disableUserMessages(userName);
+
+        QString duration = message.getTag("ban-duration");
+        QString reason = message.getTag("ban-reason");
+
+        if (duration.isEmpty()) {
+            text = userName + " has been permanently banned";
+        } else {
+            text = userName + " has been timed out for " + duration + " second" +
+                   (duration == "1" ? "" : "s");
+        }
+
+        text += reason.isEmpty() ? "." : ": \"" + reason + "\"";
+    }
+
+    messages::MessageBuilder builder;
+    builder.appendTimestamp();
+    builder.appendWord(Word(text, Word::Text, systemMessageColor, text, QString()));
+
+    c->addMessage(builder.build());
 }
 
-void IrcManager::handleUserStateMessage(Communi::IrcMessage *message)
+void IrcManager::handleUserStateMessage(const twitch::RawIrcMessage &message)
 {
-    // do nothing
+    // moderators and the broadcaster have higher message limits
+    bool isModerator = message.getRawTag("mod") == "1" ||
+                       message.getRawTag("badges").startsWith("broadcaster/");
+
+    std::lock_guard<std::mutex> locker(this->connectionMutex);
+
+    if (this->sendQueue) {
+        QMetaObject::invokeMethod(this->sendQueue.get(), "setModerator", Qt::QueuedConnection,
+                                  Q_ARG(QString, message.getChannelName()),
+                                  Q_ARG(bool, isModerator));
+    }
 }
 
-void IrcManager::handleWhisperMessage(Communi::IrcMessage *message)
+void IrcManager::handleWhisperMessage(const twitch::RawIrcMessage &message)
 {
-    // do nothing
+    messages::MessageParseArgs args;
+    args.isReceivedWhisper = true;
+
+    twitch::TwitchMessageBuilder builder(this->channelManager.whispersChannel.get(),
+                                         this->resources, this->emoteManager,
+                                         this->windowManager, this->highlightEngine, message,
+                                         args);
+
+    this->channelManager.whispersChannel->addMessage(builder.parse());
 }
 
-void IrcManager::handleUserNoticeMessage(Communi::IrcMessage *message)
+void IrcManager::handleUserNoticeMessage(const twitch::RawIrcMessage &message)
 {
     // do nothing
 }
 
 bool IrcManager::isTwitchBlockedUser(QString const &username)
 {
-    QMutexLocker locker(&_twitchBlockedUsersMutex);
-
-    auto iterator = _twitchBlockedUsers.find(username);
-
-    return iterator != _twitchBlockedUsers.end();
+    return this->blockedUsers.isBlocked(username);
 }
 
-bool IrcManager::tryAddIgnoredUser(QString const &username, QString &errorMessage)
+void IrcManager::addIgnoredUser(QString const &username, twitch::BlockedUsers::Callback callback)
 {
-    QUrl url("https://api.twitch.tv/kraken/users/" + _account.getUserName() + "/blocks/" +
-             username + "?oauth_token=" + _account.getOAuthToken() +
-             "&client_id=" + _account.getOAuthClient());
-
-    QNetworkRequest request(url);
-    auto reply = this->networkAccessManager.put(request, QByteArray());
-    reply->waitForReadyRead(10000);
-
-    if (reply->error() == QNetworkReply::NoError) {
-        _twitchBlockedUsersMutex.lock();
-        _twitchBlockedUsers.insert(username, true);
-        _twitchBlockedUsersMutex.unlock();
-
-        return true;
-    }
-
-    reply->deleteLater();
-
-    errorMessage = "Error while ignoring user \"" + username + "\": " + reply->errorString();
-    return false;
+    this->blockedUsers.block(_account, username, callback);
 }
 
-void IrcManager::addIgnoredUser(QString const &username)
+void IrcManager::removeIgnoredUser(QString const &username,
+                                   twitch::BlockedUsers::Callback callback)
 {
-    QString errorMessage;
-    if (!tryAddIgnoredUser(username, errorMessage)) {
-        // TODO: Implement IrcManager::addIgnoredUser
-    }
+    this->blockedUsers.unblock(_account, username, callback);
 }
 
-bool IrcManager::tryRemoveIgnoredUser(QString const &username, QString &errorMessage)
+void IrcManager::updateIgnoreRules()
 {
-    QUrl url("https://api.twitch.tv/kraken/users/" + _account.getUserName() + "/blocks/" +
-             username + "?oauth_token=" + _account.getOAuthToken() +
-             "&client_id=" + _account.getOAuthClient());
-
-    QNetworkRequest request(url);
-    auto reply = this->networkAccessManager.deleteResource(request);
-    reply->waitForReadyRead(10000);
+    auto &settings = SettingsManager::getInstance();
 
-    if (reply->error() == QNetworkReply::NoError) {
-        _twitchBlockedUsersMutex.lock();
-        _twitchBlockedUsers.remove(username);
-        _twitchBlockedUsersMutex.unlock();
+    this->ingestFilter.setRules(settings.ignoredPhrases.get(), settings.ignoredEmotes.get());
+}
 
-        return true;
-    }
+void IrcManager::updateHighlightRules()
+{
+    auto &settings = SettingsManager::getInstance();
 
-    reply->deleteLater();
+    // anonymous users have no name to be mentioned by
+    QString userName = _account.isAnon() ? QString() : _account.getUserName();
 
-    errorMessage = "Error while unignoring user \"" + username + "\": " + reply->errorString();
-    return false;
+    this->highlightEngine.setRules(userName, settings.highlightPhrases.get(),
+                                   settings.highlightRegexes.get());
 }
 
-void IrcManager::removeIgnoredUser(QString const &username)
+void IrcManager::refreshIgnoredUsers()
 {
-    QString errorMessage;
-    if (!tryRemoveIgnoredUser(username, errorMessage)) {
-        // TODO: Implement IrcManager::removeIgnoredUser
-    }
+    this->blockedUsers.refresh(_account);
 }
 
 }  // namespace chatterino
@@ -2,16 +2,21 @@
 
 #define TWITCH_MAX_MESSAGELENGTH 500
 
+#include "messages/highlightengine.hpp"
 #include "messages/message.hpp"
+#include "twitch/blockedusers.hpp"
+#include "twitch/ingestfilter.hpp"
+#include "twitch/rawircmessage.hpp"
+#include "twitch/readconnectionpool.hpp"
 #include "twitch/twitchuser.hpp"
+#include "util/boundedqueue.hpp"
 
 #include <IrcMessage>
-#include <QMap>
-#include <QMutex>
-#include <QNetworkAccessManager>
 #include <QString>
+#include <QThread>
 #include <pajlada/signals/signal.hpp>
 
+#include <atomic>
 #include <memory>
 #include <mutex>
 
@@ -22,6 +27,11 @@ class Resources;
 class EmoteManager;
 class WindowManager;
 
+namespace twitch {
+class SendQueue;
+class TwitchConnection;
+}  // namespace twitch
+
 class IrcManager : public QObject
 {
     Q_OBJECT
@@ -29,27 +39,44 @@ class IrcManager : public QObject
 public:
     IrcManager(ChannelManager &_channelManager, Resources &_resources, EmoteManager &_emoteManager,
                WindowManager &_windowManager);
+    ~IrcManager();
 
     static const QString defaultClientId;
 
     void connect();
     void disconnect();
 
+    // Lock free, can be called from any thread. username must be lowercase.
     bool isTwitchBlockedUser(QString const &username);
-    bool tryAddIgnoredUser(QString const &username, QString &errorMessage);
-    void addIgnoredUser(QString const &username);
-    bool tryRemoveIgnoredUser(QString const &username, QString &errorMessage);
-    void removeIgnoredUser(QString const &username);
+
+    // The user is (un)ignored right away, and restored if the API call fails
+    void addIgnoredUser(QString const &username,
+                        twitch::BlockedUsers::Callback callback = nullptr);
+    void removeIgnoredUser(QString const &username,
+                           twitch::BlockedUsers::Callback callback = nullptr);
 
     void sendMessage(const QString &channelName, const QString &message);
 
     void joinChannel(const QString &channelName);
     void partChannel(const QString &channelName);
 
+    // Number of messages waiting to be sent, and how long the last sent message waited (ms)
+    int getSendQueueDepth();
+    qint64 getSendQueueWaitTime();
+
+    std::vector<twitch::ReadConnectionStatistics> getReadConnectionStatistics();
+
+    // Number of received messages dropped by each ignore rule
+    std::vector<twitch::IngestFilter::RuleStatistics> getIgnoreStatistics() const;
+
     const twitch::TwitchUser &getUser() const;
     void setUser(const twitch::TwitchUser &account);
 
-    pajlada::Signals::Signal<Communi::IrcPrivateMessage *> onPrivateMessage;
+    pajlada::Signals::Signal<const twitch::RawIrcMessage &> onPrivateMessage;
+
+private slots:
+    void processIncomingMessages();
+    void refreshIgnoredUsers();
 
 private:
     ChannelManager &channelManager;
@@ -60,33 +87,48 @@ private:
     // variables
     twitch::TwitchUser _account;
 
-    std::shared_ptr<Communi::IrcConnection> writeConnection = nullptr;
-    std::shared_ptr<Communi::IrcConnection> readConnection = nullptr;
+    std::shared_ptr<twitch::SendQueue> sendQueue = nullptr;
+    std::shared_ptr<twitch::ReadConnectionPool> readConnections = nullptr;
 
     std::mutex connectionMutex;
     uint32_t connectionGeneration = 0;
 
-    QMap<QString, bool> _twitchBlockedUsers;
-    QMutex _twitchBlockedUsersMutex;
+    // All connections live in this thread, so reading from the sockets and splitting/parsing
+    // lines doesn't have to wait for the GUI thread
+    QThread ioThread;
 
-    QNetworkAccessManager networkAccessManager;
+    // Messages parsed in the I/O thread, waiting to be handled in the GUI thread
+    util::BoundedQueue<twitch::RawIrcMessage> incomingMessages;
+    std::atomic<bool> incomingMessagesScheduled;
+    std::atomic<bool> readingPaused;
 
-    // methods
-    Communi::IrcConnection *createConnection(bool doRead);
+    twitch::BlockedUsers blockedUsers;
+
+    // Drops messages of ignored users and with ignored phrases in the I/O thread, before they're
+    // queued for the GUI thread
+    twitch::IngestFilter ingestFilter;
 
-    void refreshIgnoredUsers(const QString &username, const QString &oauthClient,
-                             const QString &oauthToken);
+    messages::HighlightEngine highlightEngine;
+
+    // methods
+    twitch::TwitchConnection *createWriteConnection();
+    twitch::ReadConnectionPool *createReadConnections();
 
     void beginConnecting();
+    void updateIgnoreRules();
+    void updateHighlightRules();
+
+    void enqueueIncomingMessage(twitch::TwitchConnection *connection,
+                                const twitch::RawIrcMessage &message);
 
-    void privateMessageReceived(Communi::IrcPrivateMessage *message);
-    void messageReceived(Communi::IrcMessage *message);
+    void privateMessageReceived(const twitch::RawIrcMessage &message);
+    void messageReceived(const twitch::RawIrcMessage &message);
 
-    void handleRoomStateMessage(Communi::IrcMessage *message);
-    void handleClearChatMessage(Communi::IrcMessage *message);
-    void handleUserStateMessage(Communi::IrcMessage *message);
-    void handleWhisperMessage(Communi::IrcMessage *message);
-    void handleUserNoticeMessage(Communi::IrcMessage *message);
+    void handleRoomStateMessage(const twitch::RawIrcMessage &message);
+    void handleClearChatMessage(const twitch::RawIrcMessage &message);
+    void handleUserStateMessage(const twitch::RawIrcMessage &message);
+    void handleWhisperMessage(const twitch::RawIrcMessage &message);
+    void handleUserNoticeMessage(const twitch::RawIrcMessage &message);
 };
 
 }  // namespace chatterino
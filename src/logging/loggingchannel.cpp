@@ -8,6 +8,13 @@
 namespace chatterino {
 namespace logging {
 
+namespace {
+
+// how long written lines may stay in the buffer before they're flushed to the file
+const int flushInterval = 1000;
+
+}  // namespace
+
 Channel::Channel(const QString &_channelName, const QString &_baseDirectory)
     : channelName(_channelName)
     , baseDirectory(_baseDirectory)
@@ -20,6 +27,12 @@ Channel::Channel(const QString &_channelName, const QString &_baseDirectory)
     this->fileHandle.setFileName(this->baseDirectory + QDir::separator() + this->fileName);
 
     this->fileHandle.open(QIODevice::Append);
+
+    this->flushTimer.setSingleShot(true);
+    this->flushTimer.setInterval(flushInterval);
+
+    QObject::connect(&this->flushTimer, &QTimer::timeout, [this] { this->fileHandle.flush(); });
+
     this->appendLine(this->generateOpeningString(now));
 }
 
@@ -31,17 +44,22 @@ Channel::~Channel()
 
 void Channel::append(std::shared_ptr<messages::Message> message)
 {
-    QDateTime now = QDateTime::currentDateTime();
+    this->appendLine(
+        formatLine(QDateTime::currentDateTime(), message->getUserName(), message->text));
+}
 
+QString Channel::formatLine(const QDateTime &time, const QString &userName, const QString &text)
+{
     QString str;
     str.append('[');
-    str.append(now.toString("HH:mm:ss"));
+    str.append(time.toString("HH:mm:ss"));
     str.append("] ");
-    str.append(message->getUserName());
+    str.append(userName);
     str.append(": ");
-    str.append(message->getContent());
+    str.append(text);
     str.append('\n');
-    this->appendLine(str);
+
+    return str;
 }
 
 QString Channel::generateOpeningString(const QDateTime &now) const
@@ -69,7 +87,10 @@ QString Channel::generateClosingString(const QDateTime &now) const
 void Channel::appendLine(const QString &line)
 {
     this->fileHandle.write(line.toUtf8());
-    this->fileHandle.flush();
+
+    if (!this->flushTimer.isActive()) {
+        this->flushTimer.start();
+    }
 }
 
 }  // namespace logging
@@ -5,6 +5,7 @@
 #include <QDateTime>
 #include <QFile>
 #include <QString>
+#include <QTimer>
 
 #include <memory>
 
@@ -19,6 +20,10 @@ public:
 
     void append(std::shared_ptr<messages::Message> message);
 
+    // "[HH:mm:ss] user: text", GlobalSearch reads the log files in this format
+    static QString formatLine(const QDateTime &time, const QString &userName,
+                              const QString &text);
+
 private:
     QString generateOpeningString(const QDateTime &now = QDateTime::currentDateTime()) const;
     QString generateClosingString(const QDateTime &now = QDateTime::currentDateTime()) const;
@@ -30,6 +35,9 @@ private:
     const QString &baseDirectory;
     QString fileName;
     QFile fileHandle;
+
+    // lines are written to the file in batches, not once per message
+    QTimer flushTimer;
 };
 
 }  // namespace logging
@@ -53,6 +53,11 @@ void init()
     }
 }
 
+const QString &getChannelsDirectory()
+{
+    return channelBasePath;
+}
+
 static const QString &getBaseDirectory(const QString &channelName)
 {
     if (channelName == "/whispers") {
@@ -10,5 +10,8 @@ namespace logging {
 void init();
 std::shared_ptr<Channel> get(const QString &channelName);
 
+// Directory the logs of all channels are written to, "<channel>-<yyyy-MM-dd>.log"
+const QString &getChannelsDirectory();
+
 }  // namespace logging
 }  // namespace chatterino
@@ -10,7 +10,7 @@ MessageFactory::MessageFactory(Resources &_resources, EmoteManager &_emoteManage
 {
 }
 
-messages::SharedMessage MessageFactory::buildMessage(Communi::IrcPrivateMessage *message,
+messages::SharedMessage MessageFactory::buildMessage(const twitch::RawIrcMessage &message,
                                                      Channel &channel,
                                                      const messages::MessageParseArgs &args)
 {
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "messages/message.hpp"
+#include "twitch/rawircmessage.hpp"
 
 namespace chatterino {
 
@@ -14,7 +15,7 @@ public:
     explicit MessageFactory(Resources &_resources, EmoteManager &_emoteManager,
                             WindowManager &_windowManager);
 
-    messages::SharedMessage buildMessage(Communi::IrcPrivateMessage *message, Channel &channel,
+    messages::SharedMessage buildMessage(const twitch::RawIrcMessage &message, Channel &channel,
                                          const messages::MessageParseArgs &args);
 
 private:
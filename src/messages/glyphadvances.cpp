@@ -0,0 +1,81 @@
+#include "messages/glyphadvances.hpp"
+
+#include <algorithm>
+#include <iterator>
+
+namespace chatterino {
+namespace messages {
+
+GlyphAdvances::GlyphAdvances(const QFont &font)
+    : metrics(font)
+    , height(metrics.height())
+{
+    std::fill(std::begin(this->latin1Advances), std::end(this->latin1Advances), -1);
+}
+
+int GlyphAdvances::getHeight() const
+{
+    return this->height;
+}
+
+int GlyphAdvances::getAdvance(const QString &text, int index)
+{
+    QChar character = text.at(index);
+
+    if (character.unicode() < 256) {
+        short &advance = this->latin1Advances[character.unicode()];
+
+        if (advance < 0) {
+            advance = this->metrics.width(character);
+        }
+
+        return advance;
+    }
+
+    uint codePoint = character.unicode();
+
+    if (character.isHighSurrogate() && index + 1 < text.length() &&
+        text.at(index + 1).isLowSurrogate()) {
+        codePoint = QChar::surrogateToUcs4(character, text.at(index + 1));
+    } else if (character.isLowSurrogate() && index > 0 && text.at(index - 1).isHighSurrogate()) {
+        return 0;
+    }
+
+    auto advance = this->otherAdvances.constFind(codePoint);
+
+    if (advance != this->otherAdvances.constEnd()) {
+        return advance.value();
+    }
+
+    return this->measure(codePoint);
+}
+
+int GlyphAdvances::getWidth(const QString &text)
+{
+    int width = 0;
+
+    for (int i = 0; i < text.length(); i++) {
+        width += this->getAdvance(text, i);
+    }
+
+    return width;
+}
+
+short GlyphAdvances::measure(uint codePoint)
+{
+    short advance = 0;
+
+    QChar::Category category = QChar::category(codePoint);
+
+    // combining marks are drawn on top of the character before them
+    if (category != QChar::Mark_NonSpacing && category != QChar::Mark_Enclosing) {
+        advance = this->metrics.width(QString::fromUcs4(&codePoint, 1));
+    }
+
+    this->otherAdvances.insert(codePoint, advance);
+
+    return advance;
+}
+
+}  // namespace messages
+}  // namespace chatterino
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <QFont>
+#include <QFontMetrics>
+#include <QHash>
+#include <QString>
+
+namespace chatterino {
+namespace messages {
+
+// GlyphAdvances caches how far every character moves the pen in one font, so measuring text is a
+// sum of table lookups instead of QFontMetrics calls. Latin-1 characters are kept in an array,
+// everything else in a hash. Kerning and shaping are ignored, which is close enough for wrapping
+// and hit testing chat messages.
+//
+// Not thread safe, every thread has its own tables, see TextMeasurer.
+class GlyphAdvances
+{
+public:
+    explicit GlyphAdvances(const QFont &font);
+
+    int getHeight() const;
+
+    // Advance of the character at index. Surrogate pairs are counted at their high surrogate.
+    int getAdvance(const QString &text, int index);
+
+    int getWidth(const QString &text);
+
+private:
+    QFontMetrics metrics;
+    int height;
+
+    // -1 until the character is measured
+    short latin1Advances[256];
+    QHash<uint, short> otherAdvances;
+
+    short measure(uint codePoint);
+};
+
+}  // namespace messages
+}  // namespace chatterino
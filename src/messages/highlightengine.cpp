@@ -0,0 +1,116 @@
+#include "messages/highlightengine.hpp"
+
+#include <QDebug>
+#include <QStringList>
+
+#include <vector>
+
+namespace chatterino {
+namespace messages {
+
+bool HighlightEngine::isHighlighted(const QString &senderName, const util::ByteView &content,
+                                    const QString &text) const
+{
+    // our own messages never highlight
+    if (!this->userName.isEmpty() &&
+        QString::compare(senderName, this->userName, Qt::CaseInsensitive) == 0) {
+        return false;
+    }
+
+    if (this->matcher.findFirst(content.getData(), content.getSize()) != -1) {
+        return true;
+    }
+
+    if (!this->regex.pattern().isEmpty() && this->regex.match(text).hasMatch()) {
+        return true;
+    }
+
+    for (const QRegularExpression &separateRegex : this->separateRegexes) {
+        if (separateRegex.match(text).hasMatch()) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void HighlightEngine::setRules(const QString &_userName, const QString &phrases,
+                               const QString &regexes)
+{
+    this->userName = _userName;
+
+    std::vector<util::MultiPatternMatcher::Pattern> patterns;
+
+    auto addPattern = [&patterns](const QString &text) {
+        util::MultiPatternMatcher::Pattern pattern;
+        pattern.text = text.toUtf8();
+        pattern.boundary = util::MultiPatternMatcher::Boundary::Word;
+
+        patterns.push_back(pattern);
+    };
+
+    if (!_userName.isEmpty()) {
+        addPattern(_userName);
+    }
+
+    for (const QString &line : phrases.split('\n', QString::SkipEmptyParts)) {
+        QString phrase = line.trimmed();
+
+        if (!phrase.isEmpty()) {
+            addPattern(phrase);
+        }
+    }
+
+    this->matcher = util::MultiPatternMatcher(patterns);
+
+    // (?:a)|(?:b)|..., so the regexes are evaluated in one pass
+    QStringList alternatives;
+    std::vector<QRegularExpression> validRegexes;
+
+    this->separateRegexes.clear();
+
+    for (const QString &line : regexes.split('\n', QString::SkipEmptyParts)) {
+        QString pattern = line.trimmed();
+
+        if (pattern.isEmpty()) {
+            continue;
+        }
+
+        QRegularExpression single(pattern, QRegularExpression::CaseInsensitiveOption);
+
+        if (!single.isValid()) {
+            qDebug() << "[HighlightEngine] Skipping invalid regex" << pattern << ":"
+                     << single.errorString();
+            continue;
+        }
+
+        single.optimize();
+        validRegexes.push_back(single);
+
+        // group numbers and names would change meaning in the alternation
+        if (single.captureCount() > 0) {
+            this->separateRegexes.push_back(single);
+            continue;
+        }
+
+        alternatives.append("(?:" + pattern + ")");
+    }
+
+    this->regex = QRegularExpression(alternatives.join('|'),
+                                     QRegularExpression::CaseInsensitiveOption);
+
+    if (!this->regex.isValid()) {
+        // i.e. an option setting like (*UCP), which is only allowed at the very start
+        qDebug() << "[HighlightEngine] Joined regex is invalid, matching the regexes one by one:"
+                 << this->regex.errorString();
+
+        this->regex = QRegularExpression();
+        this->separateRegexes = validRegexes;
+        return;
+    }
+
+    this->regex.optimize();
+}
+
+}  // namespace messages
+}  // namespace chatterino
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "util/byteview.hpp"
+#include "util/multipatternmatcher.hpp"
+
+#include <QRegularExpression>
+
+#include <vector>
+#include <QString>
+
+namespace chatterino {
+namespace messages {
+
+// HighlightEngine decides whether a message should highlight: it mentions the user's name or one
+// of the highlight phrases, or it matches one of the highlight regexes.
+//
+// The name and all phrases are compiled into one MultiPatternMatcher and all regexes into a single
+// alternation, so a message is scanned once no matter how many rules there are. Regexes with
+// groups are matched on their own, joining them would renumber their groups and break
+// backreferences or clash on group names.
+class HighlightEngine
+{
+public:
+    // content is the raw UTF-8 message, text the decoded one which the regexes run on
+    bool isHighlighted(const QString &senderName, const util::ByteView &content,
+                       const QString &text) const;
+
+    // Phrases and regexes are separated by newlines, invalid regexes are skipped
+    void setRules(const QString &userName, const QString &phrases, const QString &regexes);
+
+private:
+    QString userName;
+
+    util::MultiPatternMatcher matcher;
+
+    // empty if there are no valid regexes without groups
+    QRegularExpression regex;
+
+    // the regexes with groups
+    std::vector<QRegularExpression> separateRegexes;
+};
+
+}  // namespace messages
+}  // namespace chatterino
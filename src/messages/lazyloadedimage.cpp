@@ -90,6 +90,22 @@ void LazyLoadedImage::loadImage()
     });
 }
 
+void LazyLoadedImage::unload()
+{
+    // not loaded yet, or there's nothing to load it again from
+    if (_allFrames.empty() || _animated || _url.isEmpty()) {
+        return;
+    }
+
+    for (FrameData &frame : _allFrames) {
+        delete frame.image;
+    }
+
+    _allFrames.clear();
+    _currentPixmap = nullptr;
+    _isLoading = false;
+}
+
 void LazyLoadedImage::gifUpdateTimout()
 {
     _currentFrameOffset += GIF_FRAME_LENGTH;
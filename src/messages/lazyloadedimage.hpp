@@ -35,6 +35,10 @@ public:
         return _currentPixmap;
     }
 
+    // Frees the loaded frames of a static image, they're loaded again the next time the image is
+    // drawn. Does nothing for animated images and images created from a pixmap.
+    void unload();
+
     qreal getScale() const
     {
         return _scale;
@@ -47,7 +47,8 @@ public:
                 auto newVector = std::make_shared<std::vector<T>>();
                 newVector->reserve(_limit + _buffer);
 
-                for (unsigned int i = 0; i < _limit - 1; i++) {
+                // skip the deleted item
+                for (unsigned int i = 1; i < _limit; i++) {
                     newVector->push_back(_vector->at(i + _offset));
                 }
                 newVector->push_back(item);
@@ -73,6 +74,11 @@ public:
         }
     }
 
+    int getLimit() const
+    {
+        return _limit;
+    }
+
     messages::LimitedQueueSnapshot<T> getSnapshot()
     {
         std::lock_guard<std::mutex> lock(_mutex);
@@ -33,6 +33,7 @@ Message::Message(const QString &text, const std::vector<Word> &words)
     : text(text)
     , words(words)
 {
+    this->updatePresentTypes();
 }
 
 bool Message::getCanHighlightTab() const
@@ -40,6 +41,11 @@ bool Message::getCanHighlightTab() const
     return this->highlightTab;
 }
 
+void Message::setHighlightTab(bool value)
+{
+    this->highlightTab = value;
+}
+
 const QString &Message::getTimeoutUser() const
 {
     return this->timeoutUser;
@@ -55,11 +61,46 @@ const QString &Message::getUserName() const
     return this->userName;
 }
 
+void Message::setUserName(const QString &value)
+{
+    this->userName = value;
+}
+
 const QString &Message::getDisplayName() const
 {
     return this->displayName;
 }
 
+const QString &Message::getChannelName() const
+{
+    return this->channelName;
+}
+
+void Message::setChannelName(const QString &value)
+{
+    this->channelName = value;
+}
+
+const QStringList &Message::getBadges() const
+{
+    return this->badges;
+}
+
+void Message::setBadges(const QStringList &value)
+{
+    this->badges = value;
+}
+
+int Message::getBits() const
+{
+    return this->bits;
+}
+
+void Message::setBits(int value)
+{
+    this->bits = value;
+}
+
 const QString &Message::getContent() const
 {
     return this->content;
@@ -70,14 +111,105 @@ const std::chrono::time_point<std::chrono::system_clock> &Message::getParseTime(
     return this->parseTime;
 }
 
+void Message::setParseTime(const std::chrono::time_point<std::chrono::system_clock> &value)
+{
+    this->parseTime = value;
+}
+
+void Message::setWordBuilder(std::function<std::vector<Word>(const Message &)> builder)
+{
+    this->wordBuilder = builder;
+}
+
+bool Message::hasWords() const
+{
+    return this->wordsBuilt || !this->wordBuilder;
+}
+
+void Message::releaseWords()
+{
+    if (!this->wordBuilder || !this->wordsBuilt) {
+        return;
+    }
+
+    std::vector<Word>().swap(this->words);
+    this->wordsBuilt = false;
+
+    std::vector<int>().swap(this->shownWords);
+    this->shownWordsValid = false;
+}
+
+Word::Type Message::getPresentTypes() const
+{
+    return this->presentTypes;
+}
+
+const std::vector<int> &Message::getShownWords(uint32_t wordTypes)
+{
+    if (this->shownWordsValid && this->shownWordTypes == wordTypes) {
+        return this->shownWords;
+    }
+
+    std::vector<Word> &allWords = this->getWords();
+
+    this->shownWords.clear();
+
+    for (size_t i = 0; i < allWords.size(); i++) {
+        if ((allWords[i].getType() & wordTypes) != Word::None) {
+            this->shownWords.push_back(static_cast<int>(i));
+        }
+    }
+
+    this->shownWordTypes = wordTypes;
+    this->shownWordsValid = true;
+
+    return this->shownWords;
+}
+
+void Message::updatePresentTypes()
+{
+    uint32_t types = Word::None;
+
+    for (const Word &word : this->words) {
+        types |= word.getType();
+    }
+
+    this->presentTypes = static_cast<Word::Type>(types);
+}
+
 std::vector<Word> &Message::getWords()
 {
+    // the builder is kept, hibernating channels release the words again
+    if (this->wordBuilder && !this->wordsBuilt) {
+        this->words = this->wordBuilder(*this);
+        this->wordsBuilt = true;
+        this->shownWordsValid = false;
+
+        this->updatePresentTypes();
+    }
+
     return this->words;
 }
 
 bool Message::isDisabled() const
 {
-    return this->disabled;
+    return this->disabled || (this->clearEpoch && *this->clearEpoch != this->clearEpochValue);
+}
+
+void Message::setDisabled(bool value)
+{
+    this->disabled = value;
+}
+
+void Message::setClearEpoch(std::shared_ptr<const std::atomic<int>> channelClearEpoch)
+{
+    this->clearEpoch = channelClearEpoch;
+    this->clearEpochValue = *channelClearEpoch;
+}
+
+bool Message::hasClearEpoch() const
+{
+    return this->clearEpoch != nullptr;
 }
 
 const QString &Message::getId() const
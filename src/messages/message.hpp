@@ -6,10 +6,14 @@
 #include "messages/wordpart.hpp"
 
 #include <IrcMessage>
+#include <QStringList>
 #include <QVector>
 
+#include <atomic>
 #include <chrono>
+#include <functional>
 #include <memory>
+#include <vector>
 
 namespace chatterino {
 
@@ -27,14 +31,49 @@ public:
     explicit Message(const QString &text, const std::vector<messages::Word> &words);
 
     bool getCanHighlightTab() const;
+    void setHighlightTab(bool value);
     const QString &getTimeoutUser() const;
     int getTimeoutCount() const;
     const QString &getUserName() const;
+    void setUserName(const QString &value);
     const QString &getDisplayName() const;
+    const QString &getChannelName() const;
+    void setChannelName(const QString &value);
+
+    // Badge names without their version, e.g. "moderator" or "subscriber"
+    const QStringList &getBadges() const;
+    void setBadges(const QStringList &value);
+    int getBits() const;
+    void setBits(int value);
     const QString &getContent() const;
     const std::chrono::time_point<std::chrono::system_clock> &getParseTime() const;
+    void setParseTime(const std::chrono::time_point<std::chrono::system_clock> &value);
+    // Builds the words first if the message was created without them
     std::vector<Word> &getWords();
+
+    // Messages of background channels are only built into words once something lays them out,
+    // until then they keep just what's needed to build them. Must be called from the GUI thread.
+    void setWordBuilder(std::function<std::vector<Word>(const Message &)> builder);
+    bool hasWords() const;
+
+    // Frees the words of a message with a word builder, they're built again when needed. Nothing
+    // may reference the words anymore, i.e. no MessageRef of the message may be laid out.
+    void releaseWords();
+
+    // All types of words the message has, known once the words were built. Changes of other
+    // types in the word type mask don't affect the message.
+    Word::Type getPresentTypes() const;
+
+    // Indices of the words shown with wordTypes, in order. Kept until it's called with different
+    // word types. Must be called from the GUI thread.
+    const std::vector<int> &getShownWords(uint32_t wordTypes);
     bool isDisabled() const;
+    void setDisabled(bool value);
+
+    // The message counts as disabled once the channel's clear epoch moves past the value it had
+    // here, which disables all messages of a channel at once
+    void setClearEpoch(std::shared_ptr<const std::atomic<int>> channelClearEpoch);
+    bool hasClearEpoch() const;
     const QString &getId() const;
 
     const QString text;
@@ -54,14 +93,29 @@ private:
     QString timeoutUser = "";
     int timeoutCount = 0;
     bool disabled = false;
+    std::shared_ptr<const std::atomic<int>> clearEpoch;
+    int clearEpochValue = 0;
     std::chrono::time_point<std::chrono::system_clock> parseTime;
 
     QString userName = "";
     QString displayName = "";
+    QString channelName;
+    QStringList badges;
+    int bits = 0;
     QString content;
     QString id = "";
 
     std::vector<Word> words;
+    std::function<std::vector<Word>(const Message &)> wordBuilder;
+    bool wordsBuilt = false;
+
+    Word::Type presentTypes = Word::None;
+
+    std::vector<int> shownWords;
+    uint32_t shownWordTypes = 0;
+    bool shownWordsValid = false;
+
+    void updatePresentTypes();
 };
 
 }  // namespace messages
@@ -16,7 +16,20 @@ MessageBuilder::MessageBuilder()
 
 SharedMessage MessageBuilder::build()
 {
-    return SharedMessage(new Message(this->originalMessage, _words));
+    SharedMessage message(new Message(this->originalMessage, _words));
+    message->setHighlightTab(_highlight);
+    message->setUserName(_userName);
+    message->setChannelName(_channelName);
+    message->setBadges(_badges);
+    message->setBits(_bits);
+    message->setParseTime(_parseTime);
+
+    return message;
+}
+
+std::vector<Word> MessageBuilder::takeWords()
+{
+    return std::move(_words);
 }
 
 void MessageBuilder::appendWord(const Word &word)
@@ -52,6 +65,31 @@ void MessageBuilder::appendTimestamp(time_t time)
                     QString()));
 }
 
+void MessageBuilder::setHighlight(bool value)
+{
+    _highlight = value;
+}
+
+void MessageBuilder::setUserName(const QString &value)
+{
+    _userName = value;
+}
+
+void MessageBuilder::setChannelName(const QString &value)
+{
+    _channelName = value;
+}
+
+void MessageBuilder::setBadges(const QStringList &value)
+{
+    _badges = value;
+}
+
+void MessageBuilder::setBits(int value)
+{
+    _bits = value;
+}
+
 QString MessageBuilder::matchLink(const QString &string)
 {
     QString match = regex.match(string,0,QRegularExpression::PartialPreferCompleteMatch,QRegularExpression::NoMatchOption).captured();
@@ -15,9 +15,17 @@ public:
 
     SharedMessage build();
 
+    // Moves the appended words out of the builder
+    std::vector<Word> takeWords();
+
     void appendWord(const Word &word);
     void appendTimestamp();
     void appendTimestamp(std::time_t time);
+    void setHighlight(bool value);
+    void setUserName(const QString &value);
+    void setChannelName(const QString &value);
+    void setBadges(const QStringList &value);
+    void setBits(int value);
 
     QString matchLink(const QString &string);
     QRegularExpression regex;
@@ -27,6 +35,11 @@ public:
 private:
     std::vector<Word> _words;
     std::chrono::time_point<std::chrono::system_clock> _parseTime;
+    bool _highlight = false;
+    QString _userName;
+    QString _channelName;
+    QStringList _badges;
+    int _bits = 0;
 };
 
 }  // namespace messages
@@ -0,0 +1,658 @@
+#include "messages/messagefilter.hpp"
+#include "messages/message.hpp"
+
+#include <QRegularExpression>
+#include <QStringList>
+
+#include <vector>
+
+namespace chatterino {
+namespace messages {
+
+namespace {
+
+using Predicate = std::function<bool(const Message &)>;
+
+struct Token {
+    enum Type {
+        Identifier,
+        String,
+        Number,
+        Regex,
+        Operator,
+        End,
+    };
+
+    Type type;
+    QString text;
+
+    // regex flags
+    QString flags;
+
+    int position;
+};
+
+// Every value has its type fixed at compile time, only the function matching the type is set
+struct Operand {
+    enum Type {
+        Bool,
+        Number,
+        String,
+        List,
+        Regex,
+    };
+
+    Type type;
+
+    std::function<bool(const Message &)> boolean;
+    std::function<int(const Message &)> number;
+    std::function<QString(const Message &)> string;
+    std::function<QStringList(const Message &)> list;
+    QRegularExpression regex;
+
+    // literals are folded into the comparisons instead of being called for every message
+    bool isConstant = false;
+    QString constantString;
+    int constantNumber = 0;
+};
+
+const char *getTypeName(Operand::Type type)
+{
+    switch (type) {
+        case Operand::Bool:
+            return "boolean";
+        case Operand::Number:
+            return "number";
+        case Operand::String:
+            return "text";
+        case Operand::List:
+            return "list";
+        case Operand::Regex:
+            return "regex";
+    }
+
+    return "value";
+}
+
+bool tokenize(const QString &expression, std::vector<Token> &tokens, QString &errorMessage)
+{
+    int i = 0;
+    int length = expression.length();
+
+    while (i < length) {
+        QChar c = expression[i];
+
+        if (c.isSpace()) {
+            i++;
+            continue;
+        }
+
+        Token token;
+        token.position = i;
+
+        if (c.isLetter() || c == '_') {
+            int start = i;
+
+            while (i < length && (expression[i].isLetterOrNumber() || expression[i] == '_' ||
+                                  expression[i] == '.')) {
+                i++;
+            }
+
+            token.type = Token::Identifier;
+            token.text = expression.mid(start, i - start);
+        } else if (c.isDigit()) {
+            int start = i;
+
+            while (i < length && expression[i].isDigit()) {
+                i++;
+            }
+
+            token.type = Token::Number;
+            token.text = expression.mid(start, i - start);
+        } else if (c == '"') {
+            // "text", \" and \\ are escapes
+            i++;
+
+            while (i < length && expression[i] != '"') {
+                if (expression[i] == '\\' && i + 1 < length) {
+                    i++;
+                }
+
+                token.text += expression[i];
+                i++;
+            }
+
+            if (i == length) {
+                errorMessage = QString("Unterminated string at %1").arg(token.position + 1);
+                return false;
+            }
+
+            i++;
+            token.type = Token::String;
+        } else if (c == '/') {
+            // /regex/flags, \/ is an escaped slash, other escapes are passed on to the regex
+            i++;
+
+            while (i < length && expression[i] != '/') {
+                if (expression[i] == '\\' && i + 1 < length && expression[i + 1] == '/') {
+                    i++;
+                } else if (expression[i] == '\\' && i + 1 < length) {
+                    token.text += expression[i];
+                    i++;
+                }
+
+                token.text += expression[i];
+                i++;
+            }
+
+            if (i == length) {
+                errorMessage = QString("Unterminated regex at %1").arg(token.position + 1);
+                return false;
+            }
+
+            i++;
+
+            while (i < length && expression[i].isLetter()) {
+                token.flags += expression[i];
+                i++;
+            }
+
+            token.type = Token::Regex;
+        } else {
+            static const QStringList operators{"||", "&&", "==", "!=", "<=", ">=",
+                                               "<",  ">",  "!",  "(",  ")"};
+
+            for (const QString &op : operators) {
+                if (expression.midRef(i, op.length()) == op) {
+                    token.text = op;
+                    break;
+                }
+            }
+
+            if (token.text.isEmpty()) {
+                errorMessage = QString("Unexpected \"%1\" at %2").arg(c).arg(i + 1);
+                return false;
+            }
+
+            i += token.text.length();
+            token.type = Token::Operator;
+        }
+
+        tokens.push_back(token);
+    }
+
+    Token end;
+    end.type = Token::End;
+    end.position = length;
+    tokens.push_back(end);
+
+    return true;
+}
+
+// Recursive descent, lowest precedence first:
+//   or         := and ("||" and)*
+//   and        := not ("&&" not)*
+//   not        := "!" not | comparison
+//   comparison := primary (operator primary)?
+//   primary    := "(" or ")" | literal | field
+class Parser
+{
+public:
+    Parser(const std::vector<Token> &_tokens)
+        : tokens(_tokens)
+    {
+    }
+
+    bool parse(Predicate &predicate, QString &errorMessage)
+    {
+        Operand result;
+
+        if (!this->parseOr(result) || !this->expectBool(result, this->tokens[0])) {
+            errorMessage = this->error;
+            return false;
+        }
+
+        if (this->peek().type != Token::End) {
+            errorMessage = this->unexpected(this->peek());
+            return false;
+        }
+
+        predicate = result.boolean;
+        return true;
+    }
+
+private:
+    const std::vector<Token> &tokens;
+    size_t index = 0;
+    QString error;
+
+    const Token &peek() const
+    {
+        return this->tokens[this->index];
+    }
+
+    bool accept(const QString &op)
+    {
+        const Token &token = this->peek();
+
+        if ((token.type == Token::Operator || token.type == Token::Identifier) &&
+            token.text == op) {
+            this->index++;
+            return true;
+        }
+
+        return false;
+    }
+
+    QString unexpected(const Token &token) const
+    {
+        if (token.type == Token::End) {
+            return "Unexpected end of the filter";
+        }
+
+        return QString("Unexpected \"%1\" at %2").arg(token.text).arg(token.position + 1);
+    }
+
+    bool fail(const QString &message)
+    {
+        this->error = message;
+        return false;
+    }
+
+    bool expectBool(const Operand &operand, const Token &token)
+    {
+        if (operand.type != Operand::Bool) {
+            return this->fail(QString("Expected a condition at %1, got a %2")
+                                  .arg(token.position + 1)
+                                  .arg(getTypeName(operand.type)));
+        }
+
+        return true;
+    }
+
+    bool parseOr(Operand &result)
+    {
+        const Token &first = this->peek();
+
+        if (!this->parseAnd(result)) {
+            return false;
+        }
+
+        while (this->peek().text == "||" && this->peek().type == Token::Operator) {
+            const Token &token = this->tokens[++this->index];
+            Operand right;
+
+            if (!this->expectBool(result, first) || !this->parseAnd(right) ||
+                !this->expectBool(right, token)) {
+                return false;
+            }
+
+            Predicate a = result.boolean;
+            Predicate b = right.boolean;
+
+            result.boolean = [a, b](const Message &message) { return a(message) || b(message); };
+        }
+
+        return true;
+    }
+
+    bool parseAnd(Operand &result)
+    {
+        const Token &first = this->peek();
+
+        if (!this->parseNot(result)) {
+            return false;
+        }
+
+        while (this->peek().text == "&&" && this->peek().type == Token::Operator) {
+            const Token &token = this->tokens[++this->index];
+            Operand right;
+
+            if (!this->expectBool(result, first) || !this->parseNot(right) ||
+                !this->expectBool(right, token)) {
+                return false;
+            }
+
+            Predicate a = result.boolean;
+            Predicate b = right.boolean;
+
+            result.boolean = [a, b](const Message &message) { return a(message) && b(message); };
+        }
+
+        return true;
+    }
+
+    bool parseNot(Operand &result)
+    {
+        if (this->peek().type == Token::Operator && this->peek().text == "!") {
+            this->index++;
+            const Token &token = this->peek();
+
+            if (!this->parseNot(result) || !this->expectBool(result, token)) {
+                return false;
+            }
+
+            Predicate a = result.boolean;
+
+            result.boolean = [a](const Message &message) { return !a(message); };
+            return true;
+        }
+
+        return this->parseComparison(result);
+    }
+
+    bool parseComparison(Operand &result)
+    {
+        if (!this->parsePrimary(result)) {
+            return false;
+        }
+
+        static const QStringList comparisons{"==",       "!=",         "<",      "<=", ">", ">=",
+                                             "contains", "startswith", "matches"};
+
+        const Token &opToken = this->peek();
+
+        if ((opToken.type != Token::Operator && opToken.type != Token::Identifier) ||
+            !comparisons.contains(opToken.text)) {
+            return true;
+        }
+
+        this->index++;
+
+        Operand left = result;
+        Operand right;
+
+        if (!this->parsePrimary(right)) {
+            return false;
+        }
+
+        const QString &op = opToken.text;
+
+        auto mismatch = [&] {
+            return this->fail(QString("Can't use \"%1\" on a %2 and a %3 at %4")
+                                  .arg(op)
+                                  .arg(getTypeName(left.type))
+                                  .arg(getTypeName(right.type))
+                                  .arg(opToken.position + 1));
+        };
+
+        result = Operand();
+        result.type = Operand::Bool;
+
+        if (op == "matches") {
+            if (left.type != Operand::String || right.type != Operand::Regex) {
+                return mismatch();
+            }
+
+            auto string = left.string;
+            QRegularExpression regex = right.regex;
+
+            result.boolean = [string, regex](const Message &message) {
+                return regex.match(string(message)).hasMatch();
+            };
+        } else if (op == "contains") {
+            if (right.type != Operand::String ||
+                (left.type != Operand::String && left.type != Operand::List)) {
+                return mismatch();
+            }
+
+            result.boolean = this->compareStrings(
+                left, right, [](const Operand &l, const Message &message, const QString &value) {
+                    if (l.type == Operand::List) {
+                        return l.list(message).contains(value, Qt::CaseInsensitive);
+                    }
+
+                    return l.string(message).contains(value, Qt::CaseInsensitive);
+                });
+        } else if (op == "startswith") {
+            if (left.type != Operand::String || right.type != Operand::String) {
+                return mismatch();
+            }
+
+            result.boolean = this->compareStrings(
+                left, right, [](const Operand &l, const Message &message, const QString &value) {
+                    return l.string(message).startsWith(value, Qt::CaseInsensitive);
+                });
+        } else if (op == "==" || op == "!=") {
+            if (left.type != right.type || left.type == Operand::List ||
+                left.type == Operand::Regex) {
+                return mismatch();
+            }
+
+            bool equal = op == "==";
+
+            if (left.type == Operand::String) {
+                result.boolean = this->compareStrings(
+                    left, right,
+                    [equal](const Operand &l, const Message &message, const QString &value) {
+                        return (QString::compare(l.string(message), value, Qt::CaseInsensitive) ==
+                                0) == equal;
+                    });
+            } else if (left.type == Operand::Number) {
+                result.boolean = this->compareNumbers(
+                    left, right, [equal](int a, int b) { return (a == b) == equal; });
+            } else {
+                auto a = left.boolean;
+                auto b = right.boolean;
+
+                result.boolean = [a, b, equal](const Message &message) {
+                    return (a(message) == b(message)) == equal;
+                };
+            }
+        } else {
+            if (left.type != Operand::Number || right.type != Operand::Number) {
+                return mismatch();
+            }
+
+            if (op == "<") {
+                result.boolean =
+                    this->compareNumbers(left, right, [](int a, int b) { return a < b; });
+            } else if (op == "<=") {
+                result.boolean =
+                    this->compareNumbers(left, right, [](int a, int b) { return a <= b; });
+            } else if (op == ">") {
+                result.boolean =
+                    this->compareNumbers(left, right, [](int a, int b) { return a > b; });
+            } else {
+                result.boolean =
+                    this->compareNumbers(left, right, [](int a, int b) { return a >= b; });
+            }
+        }
+
+        return true;
+    }
+
+    template <typename Compare>
+    Predicate compareStrings(const Operand &left, const Operand &right, Compare compare)
+    {
+        if (right.isConstant) {
+            QString value = right.constantString;
+
+            return [left, value, compare](const Message &message) {
+                return compare(left, message, value);
+            };
+        }
+
+        auto string = right.string;
+
+        return [left, string, compare](const Message &message) {
+            return compare(left, message, string(message));
+        };
+    }
+
+    template <typename Compare>
+    Predicate compareNumbers(const Operand &left, const Operand &right, Compare compare)
+    {
+        auto a = left.number;
+
+        if (right.isConstant) {
+            int value = right.constantNumber;
+
+            return [a, value, compare](const Message &message) {
+                return compare(a(message), value);
+            };
+        }
+
+        auto b = right.number;
+
+        return [a, b, compare](const Message &message) { return compare(a(message), b(message)); };
+    }
+
+    bool parsePrimary(Operand &result)
+    {
+        const Token &token = this->peek();
+
+        if (token.type == Token::End) {
+            return this->fail(this->unexpected(token));
+        }
+
+        this->index++;
+
+        switch (token.type) {
+            case Token::String: {
+                result.type = Operand::String;
+                result.isConstant = true;
+                result.constantString = token.text;
+
+                QString value = token.text;
+                result.string = [value](const Message &) { return value; };
+                return true;
+            }
+
+            case Token::Number: {
+                result.type = Operand::Number;
+                result.isConstant = true;
+                result.constantNumber = token.text.toInt();
+
+                int value = result.constantNumber;
+                result.number = [value](const Message &) { return value; };
+                return true;
+            }
+
+            case Token::Regex: {
+                QRegularExpression::PatternOptions options =
+                    QRegularExpression::DontCaptureOption;
+
+                for (QChar flag : token.flags) {
+                    if (flag == 'i') {
+                        options |= QRegularExpression::CaseInsensitiveOption;
+                    } else {
+                        return this->fail(QString("Unknown regex flag \"%1\" at %2")
+                                              .arg(flag)
+                                              .arg(token.position + 1));
+                    }
+                }
+
+                result.type = Operand::Regex;
+                result.regex = QRegularExpression(token.text, options);
+
+                if (!result.regex.isValid()) {
+                    return this->fail(QString("Invalid regex at %1: %2")
+                                          .arg(token.position + 1)
+                                          .arg(result.regex.errorString()));
+                }
+
+                result.regex.optimize();
+                return true;
+            }
+
+            case Token::Identifier:
+                return this->parseField(token, result);
+
+            case Token::Operator:
+                if (token.text == "(") {
+                    if (!this->parseOr(result)) {
+                        return false;
+                    }
+
+                    if (!this->accept(")")) {
+                        return this->fail(this->unexpected(this->peek()));
+                    }
+
+                    return true;
+                }
+                break;
+
+            case Token::End:
+                break;
+        }
+
+        return this->fail(this->unexpected(token));
+    }
+
+    bool parseField(const Token &token, Operand &result)
+    {
+        const QString &name = token.text;
+
+        if (name == "true" || name == "false") {
+            bool value = name == "true";
+
+            result.type = Operand::Bool;
+            result.boolean = [value](const Message &) { return value; };
+        } else if (name == "author.name") {
+            result.type = Operand::String;
+            result.string = [](const Message &message) { return message.getUserName(); };
+        } else if (name == "author.badges") {
+            result.type = Operand::List;
+            result.list = [](const Message &message) { return message.getBadges(); };
+        } else if (name == "channel.name") {
+            result.type = Operand::String;
+            result.string = [](const Message &message) { return message.getChannelName(); };
+        } else if (name == "message.content") {
+            result.type = Operand::String;
+            result.string = [](const Message &message) { return message.text; };
+        } else if (name == "message.bits") {
+            result.type = Operand::Number;
+            result.number = [](const Message &message) { return message.getBits(); };
+        } else if (name == "message.hasBits") {
+            result.type = Operand::Bool;
+            result.boolean = [](const Message &message) { return message.getBits() > 0; };
+        } else if (name == "message.highlighted") {
+            result.type = Operand::Bool;
+            result.boolean = [](const Message &message) { return message.getCanHighlightTab(); };
+        } else {
+            return this->fail(
+                QString("Unknown field \"%1\" at %2").arg(name).arg(token.position + 1));
+        }
+
+        return true;
+    }
+};
+
+}  // namespace
+
+bool MessageFilter::compile(const QString &expression, QString &errorMessage)
+{
+    if (expression.trimmed().isEmpty()) {
+        this->predicate = nullptr;
+        return true;
+    }
+
+    std::vector<Token> tokens;
+
+    if (!tokenize(expression, tokens, errorMessage)) {
+        return false;
+    }
+
+    Predicate newPredicate;
+
+    if (!Parser(tokens).parse(newPredicate, errorMessage)) {
+        return false;
+    }
+
+    this->predicate = newPredicate;
+    return true;
+}
+
+bool MessageFilter::isEmpty() const
+{
+    return !this->predicate;
+}
+
+bool MessageFilter::accepts(const Message &message) const
+{
+    return !this->predicate || this->predicate(message);
+}
+
+}  // namespace messages
+}  // namespace chatterino
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <QString>
+
+#include <functional>
+
+namespace chatterino {
+namespace messages {
+
+class Message;
+
+// MessageFilter decides which messages a split shows, e.g.
+//   author.badges contains "moderator" || message.content matches /pog+/i || message.hasBits
+//
+// The expression is compiled once into a tree of closures with all types checked up front, so
+// evaluating it per message is a handful of indirect calls and comparisons.
+//
+// Fields:    author.name, author.badges, channel.name, message.content, message.bits,
+//            message.hasBits, message.highlighted
+// Operators: || && ! ( ) == != < <= > >= contains startswith matches
+// Literals:  "text", 123, true, false, /regex/ (/regex/i is case insensitive)
+//
+// String comparisons are case insensitive.
+class MessageFilter
+{
+public:
+    // Returns false and sets errorMessage if the expression is invalid, the filter is unchanged
+    // then. An empty expression accepts all messages.
+    bool compile(const QString &expression, QString &errorMessage);
+
+    bool isEmpty() const;
+    bool accepts(const Message &message) const;
+
+private:
+    std::function<bool(const Message &)> predicate;
+};
+
+}  // namespace messages
+}  // namespace chatterino
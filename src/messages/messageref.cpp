@@ -1,5 +1,6 @@
 #include "messageref.hpp"
 #include "emotemanager.hpp"
+#include "messages/textmeasurer.hpp"
 #include "settingsmanager.hpp"
 
 #include <QDebug>
@@ -14,6 +15,181 @@ using namespace chatterino::messages;
 namespace chatterino {
 namespace messages {
 
+namespace {
+
+const int spaceWidth = 4;
+
+// layouts kept for widths other than the current one
+const size_t maxStoredLayouts = 3;
+
+// The size an image word is shown at
+QSize getImageSize(LazyLoadedImage &image, int lineHeight, qreal emoteScale,
+                   bool scaleEmotesByLineHeight)
+{
+    qreal w = image.getWidth();
+    qreal h = image.getHeight();
+
+    if (scaleEmotesByLineHeight) {
+        return QSize(w * lineHeight / h * emoteScale, lineHeight * emoteScale);
+    }
+
+    return QSize(w * image.getScale() * emoteScale, h * image.getScale() * emoteScale);
+}
+
+uint combineImageSize(uint hash, int width, int height)
+{
+    return (hash * 31 + width) * 31 + height;
+}
+
+void measureWord(MessageRef::LayoutWord &word, const FontManager::Snapshot &fonts)
+{
+    if (word.needsMeasuring) {
+        GlyphAdvances &advances = TextMeasurer::getAdvances(fonts, word.font);
+
+        word.width = advances.getWidth(word.text);
+        word.height = advances.getHeight();
+        word.needsMeasuring = false;
+    }
+}
+
+// Places words one after another, wrapping them at the right edge
+class Positioner
+{
+public:
+    Positioner(int width, const FontManager::Snapshot &_fonts)
+        : fonts(_fonts)
+        , right(width - MARGIN_RIGHT)
+    {
+    }
+
+    int x = MARGIN_LEFT;
+    int y = MARGIN_TOP;
+
+    int lineNumber = 0;
+    int lineStart = 0;
+    int lineHeight = 0;
+    bool first = true;
+
+    std::vector<MessageRef::LayoutPart> parts;
+
+    void add(const MessageRef::LayoutWord &word)
+    {
+        // word wrapping
+        if (word.isText && word.width + MARGIN_LEFT > this->right) {
+            this->alignLine(this->lineHeight);
+
+            this->y += this->lineHeight;
+
+            const QString &text = word.text;
+            GlyphAdvances &advances = TextMeasurer::getAdvances(this->fonts, word.font);
+
+            int start = 0;
+            int width = 0;
+
+            for (int i = 2; i <= text.length(); i++) {
+                if ((width = width + advances.getAdvance(text, i - 1)) + MARGIN_LEFT >
+                    this->right) {
+                    this->addPiece(word, MARGIN_LEFT, this->y, width,
+                                   text.mid(start, i - start - 1));
+
+                    this->y += advances.getHeight();
+
+                    start = i - 1;
+
+                    width = 0;
+                    this->lineNumber++;
+                }
+            }
+
+            QString mid(text.mid(start));
+            width = advances.getWidth(mid);
+
+            this->addPiece(word, MARGIN_LEFT, this->y - word.height, width, mid);
+
+            this->x = width + MARGIN_LEFT + spaceWidth;
+
+            this->lineHeight = word.height;
+
+            this->lineStart = this->parts.size() - 1;
+
+            this->first = false;
+        } else if (this->first || this->x + word.width + word.xOffset <= this->right) {
+            // fits in the line
+            this->addPart(word, this->x, this->y - word.height, word.width);
+
+            this->x += word.width + word.xOffset;
+            this->x += spaceWidth;
+
+            this->lineHeight = std::max(word.height, this->lineHeight);
+
+            this->first = false;
+        } else {
+            // doesn't fit in the line
+            this->alignLine(this->lineHeight);
+
+            this->y += this->lineHeight;
+
+            this->addPart(word, MARGIN_LEFT, this->y - word.height, word.width);
+
+            this->lineStart = this->parts.size() - 1;
+
+            this->lineHeight = word.height;
+
+            this->x = word.width + MARGIN_LEFT;
+            this->x += spaceWidth;
+
+            this->lineNumber++;
+        }
+    }
+
+    void finish()
+    {
+        this->alignLine(this->lineHeight);
+    }
+
+    // the parts of the current line are placed on top of its bottom edge
+    void alignLine(int height)
+    {
+        for (size_t i = this->lineStart; i < this->parts.size(); i++) {
+            this->parts[i].y += height;
+        }
+    }
+
+    int getHeight() const
+    {
+        return this->y + this->lineHeight;
+    }
+
+private:
+    const FontManager::Snapshot &fonts;
+    int right;
+
+    void addPart(const MessageRef::LayoutWord &word, int partX, int partY, int width)
+    {
+        MessageRef::LayoutPart part;
+        part.wordIndex = word.index;
+        part.x = partX;
+        part.y = partY;
+        part.width = width;
+        part.height = word.height;
+        part.lineNumber = this->lineNumber;
+        part.isPiece = false;
+
+        this->parts.push_back(std::move(part));
+    }
+
+    void addPiece(const MessageRef::LayoutWord &word, int partX, int partY, int width,
+                  const QString &text)
+    {
+        this->addPart(word, partX, partY, width);
+
+        this->parts.back().isPiece = true;
+        this->parts.back().text = text;
+    }
+};
+
+}  // namespace
+
 MessageRef::MessageRef(SharedMessage message)
     : _message(message)
     , _wordParts()
@@ -30,197 +206,298 @@ int MessageRef::getHeight() const
     return _height;
 }
 
+bool MessageRef::isLayoutValid(int width) const
+{
+    return width == _currentLayoutWidth &&
+           _fontGeneration == FontManager::getInstance().getGeneration() &&
+           this->showsSameWords(_currentWordTypes);
+}
+
+bool MessageRef::showsSameWords(Word::Type wordTypes) const
+{
+    uint32_t changedTypes = wordTypes ^ SettingsManager::getInstance().getWordTypeMask();
+
+    return (changedTypes & _message->getPresentTypes()) == Word::None;
+}
+
 bool MessageRef::layout(int width, bool enableEmoteMargins)
 {
-    auto &settings = SettingsManager::getInstance();
+    // images that finished loading or changed their scale since change the hash
+    if (this->isLayoutValid(width) && _imageSizeHash == this->getImageSizeHash()) {
+        return false;
+    }
 
-    bool sizeChanged = width != _currentLayoutWidth;
-    bool redraw = width != _currentLayoutWidth;
-    int spaceWidth = 4;
+    if (this->restoreLayout(width)) {
+        return true;
+    }
 
-    int mediumTextLineHeight =
-        FontManager::getInstance().getFontMetrics(FontManager::Medium).height();
+    return this->applyLayout(computeLayout(this->prepareLayout(width, enableEmoteMargins)));
+}
+
+MessageRef::LayoutInput MessageRef::prepareLayout(int width, bool enableEmoteMargins)
+{
+    auto &settings = SettingsManager::getInstance();
+    auto &fontManager = FontManager::getInstance();
+
+    LayoutInput input;
+    input.width = width;
+    input.wordTypes = settings.getWordTypeMask();
+    input.fonts = fontManager.getSnapshot();
 
-    /* TODO(pajlada): Re-implement
-    bool recalculateImages = _emoteGeneration != EmoteManager::getInstance().getGeneration();
-    */
-    bool recalculateImages = true;
+    // the sizes of the text words are kept in the words until the font or the shown words change
+    bool recalculateText =
+        _fontGeneration != input.fonts->generation || !this->showsSameWords(_currentWordTypes);
 
-    bool recalculateText = _fontGeneration != FontManager::getInstance().getGeneration();
-    bool newWordTypes = _currentWordTypes != SettingsManager::getInstance().getWordTypeMask();
+    int mediumTextLineHeight = fontManager.getFontMetrics(FontManager::Medium).height();
 
     qreal emoteScale = settings.emoteScale.get();
     bool scaleEmotesByLineHeight = settings.scaleEmotesByLineHeight.get();
 
-    // calculate word sizes
-    if (!redraw && !recalculateImages && !recalculateText && !newWordTypes) {
-        return false;
+    uint32_t flags = input.wordTypes;
+
+    if (this->showChannelName) {
+        flags |= Word::ChannelName;
     }
 
-    // _emoteGeneration = EmoteManager::getInstance().getGeneration();
-    _fontGeneration = FontManager::getInstance().getGeneration();
+    std::vector<Word> &words = _message->getWords();
+
+    for (int i : _message->getShownWords(flags)) {
+        Word &word = words[i];
 
-    for (auto &word : _message->getWords()) {
+        // images are measured right away, their sizes come from the loaded pixmaps
         if (word.isImage()) {
-            if (!recalculateImages) {
-                continue;
-            }
+            QSize size = getImageSize(word.getImage(), mediumTextLineHeight, emoteScale,
+                                      scaleEmotesByLineHeight);
 
-            auto &image = word.getImage();
+            word.setSize(size.width(), size.height());
+        }
 
-            qreal w = image.getWidth();
-            qreal h = image.getHeight();
+        LayoutWord layoutWord;
+        layoutWord.index = i;
+        layoutWord.isText = word.isText();
+        layoutWord.needsMeasuring = word.isText() && recalculateText;
+        layoutWord.font = word.getFontType();
+        layoutWord.width = word.getWidth();
+        layoutWord.height = word.getHeight();
+        layoutWord.xOffset = 0;
+
+        if (word.isText()) {
+            layoutWord.text = word.getText();
+        }
 
-            if (scaleEmotesByLineHeight) {
-                word.setSize(w * mediumTextLineHeight / h * emoteScale,
-                             mediumTextLineHeight * emoteScale);
+        if (enableEmoteMargins) {
+            if (word.isImage() && word.getImage().isHat()) {
+                layoutWord.xOffset = -word.getWidth() + 2;
             } else {
-                word.setSize(w * image.getScale() * emoteScale, h * image.getScale() * emoteScale);
-            }
-        } else {
-            if (!recalculateText) {
-                continue;
+                layoutWord.xOffset = word.getXOffset();
             }
-
-            QFontMetrics &metrics = word.getFontMetrics();
-            word.setSize(metrics.width(word.getText()), metrics.height());
         }
+
+        input.words.push_back(std::move(layoutWord));
     }
 
-    if (newWordTypes) {
-        _currentWordTypes = settings.getWordTypeMask();
+    return input;
+}
+
+MessageRef::LayoutResult MessageRef::computeLayout(LayoutInput input)
+{
+    LayoutResult result;
+    result.width = input.width;
+    result.fontGeneration = input.fonts->generation;
+    result.wordTypes = input.wordTypes;
+
+    const FontManager::Snapshot &fonts = *input.fonts;
+
+    Positioner positioner(input.width, fonts);
+
+    for (LayoutWord &word : input.words) {
+        measureWord(word, fonts);
+        positioner.add(word);
     }
 
-    // layout
-    _currentLayoutWidth = width;
+    positioner.finish();
 
-    int x = MARGIN_LEFT;
-    int y = MARGIN_TOP;
+    result.parts = std::move(positioner.parts);
+    result.height = positioner.getHeight();
+    result.words = std::move(input.words);
 
-    int right = width - MARGIN_RIGHT;
+    return result;
+}
 
-    int lineNumber = 0;
-    int lineStart = 0;
-    int lineHeight = 0;
-    bool first = true;
+bool MessageRef::applyLayout(const LayoutResult &result)
+{
+    if (result.fontGeneration != FontManager::getInstance().getGeneration() ||
+        !this->showsSameWords(result.wordTypes) || !_message->hasWords()) {
+        return false;
+    }
 
-    _wordParts.clear();
+    std::vector<Word> &words = _message->getWords();
 
-    uint32_t flags = settings.getWordTypeMask();
+    for (const LayoutWord &layoutWord : result.words) {
+        if (layoutWord.index >= static_cast<int>(words.size())) {
+            return false;
+        }
+
+        if (layoutWord.isText) {
+            words[layoutWord.index].setSize(layoutWord.width, layoutWord.height);
+        }
+    }
 
-    for (auto it = _message->getWords().begin(); it != _message->getWords().end(); ++it) {
-        Word &word = *it;
+    if (result.width != _currentLayoutWidth) {
+        this->storeLayout();
+    }
 
-        // Check if given word is supposed to be rendered by comparing it to the current setting
-        if ((word.getType() & flags) == Word::None) {
-            continue;
+    // a layout stored for this width is outdated now
+    for (auto it = _storedLayouts.begin(); it != _storedLayouts.end(); ++it) {
+        if (it->width == result.width) {
+            _storedLayouts.erase(it);
+            break;
         }
+    }
 
-        int xOffset = 0, yOffset = 0;
+    bool sizeChanged = result.width != _currentLayoutWidth || result.height != _height;
 
-        if (enableEmoteMargins) {
-            if (word.isImage() && word.getImage().isHat()) {
-                xOffset = -word.getWidth() + 2;
-            } else {
-                xOffset = word.getXOffset();
-                yOffset = word.getYOffset();
-            }
+    _wordParts.clear();
+    _wordParts.reserve(result.parts.size());
+
+    for (const LayoutPart &part : result.parts) {
+        Word &word = words[part.wordIndex];
+
+        if (part.isPiece) {
+            _wordParts.push_back(WordPart(word, part.x, part.y, part.width, part.height,
+                                          part.lineNumber, part.text, part.text));
+        } else {
+            _wordParts.push_back(WordPart(word, part.x, part.y, part.lineNumber,
+                                          word.getCopyText()));
         }
+    }
 
-        // word wrapping
-        if (word.isText() && word.getWidth() + MARGIN_LEFT > right) {
-            alignWordParts(lineStart, lineHeight);
+    _currentLayoutWidth = result.width;
+    _fontGeneration = result.fontGeneration;
+    _currentWordTypes = result.wordTypes;
+    _height = result.height;
 
-            y += lineHeight;
+    _imageSizeHash = 0;
 
-            const QString &text = word.getText();
+    for (const LayoutWord &layoutWord : result.words) {
+        if (!layoutWord.isText) {
+            _imageSizeHash = combineImageSize(_imageSizeHash, layoutWord.width, layoutWord.height);
+        }
+    }
 
-            int start = 0;
-            QFontMetrics &metrics = word.getFontMetrics();
+    if (sizeChanged) {
+        buffer = nullptr;
+    }
 
-            int width = 0;
+    updateBuffer = true;
 
-            std::vector<short> &charWidths = word.getCharacterWidthCache();
+    return true;
+}
 
-            if (charWidths.size() == 0) {
-                for (int i = 0; i < text.length(); i++) {
-                    charWidths.push_back(metrics.charWidth(text, i));
-                }
-            }
+bool MessageRef::restoreLayout(int width)
+{
+    if (width == _currentLayoutWidth) {
+        return false;
+    }
 
-            for (int i = 2; i <= text.length(); i++) {
-                if ((width = width + charWidths[i - 1]) + MARGIN_LEFT > right) {
-                    QString mid = text.mid(start, i - start - 1);
+    auto stored = _storedLayouts.begin();
 
-                    _wordParts.push_back(WordPart(word, MARGIN_LEFT, y, width, word.getHeight(),
-                                                  lineNumber, mid, mid));
+    while (stored != _storedLayouts.end() && stored->width != width) {
+        ++stored;
+    }
 
-                    y += metrics.height();
+    if (stored == _storedLayouts.end()) {
+        return false;
+    }
 
-                    start = i - 1;
+    // the words keep their sizes, only the shown images could have changed since
+    if (stored->fontGeneration != FontManager::getInstance().getGeneration() ||
+        !this->showsSameWords(stored->wordTypes) ||
+        stored->imageSizeHash != this->getImageSizeHash()) {
+        _storedLayouts.erase(stored);
+        return false;
+    }
 
-                    width = 0;
-                    lineNumber++;
-                }
-            }
+    StoredLayout restored = std::move(*stored);
+    _storedLayouts.erase(stored);
 
-            QString mid(text.mid(start));
-            width = metrics.width(mid);
+    this->storeLayout();
 
-            _wordParts.push_back(WordPart(word, MARGIN_LEFT, y - word.getHeight(), width,
-                                          word.getHeight(), lineNumber, mid, mid));
-            x = width + MARGIN_LEFT + spaceWidth;
+    _wordParts = std::move(restored.wordParts);
+    _height = restored.height;
+    _currentLayoutWidth = restored.width;
+    _fontGeneration = restored.fontGeneration;
+    _currentWordTypes = restored.wordTypes;
+    _imageSizeHash = restored.imageSizeHash;
 
-            lineHeight = word.getHeight();
+    buffer = std::move(restored.buffer);
+    updateBuffer = restored.updateBuffer;
+    bufferDisabled = restored.bufferDisabled;
 
-            lineStart = _wordParts.size() - 1;
+    return true;
+}
 
-            first = false;
-        } else if (first || x + word.getWidth() + xOffset <= right) {
-            // fits in the line
-            _wordParts.push_back(
-                WordPart(word, x, y - word.getHeight(), lineNumber, word.getCopyText()));
+void MessageRef::storeLayout()
+{
+    if (_currentLayoutWidth < 0) {
+        return;
+    }
 
-            x += word.getWidth() + xOffset;
-            x += spaceWidth;
+    StoredLayout stored;
+    stored.width = _currentLayoutWidth;
+    stored.fontGeneration = _fontGeneration;
+    stored.wordTypes = _currentWordTypes;
+    stored.imageSizeHash = _imageSizeHash;
+    stored.wordParts = std::move(_wordParts);
+    stored.height = _height;
+    stored.buffer = std::move(buffer);
+    stored.updateBuffer = updateBuffer;
+    stored.bufferDisabled = bufferDisabled;
 
-            lineHeight = std::max(word.getHeight(), lineHeight);
+    _wordParts.clear();
+    buffer = nullptr;
 
-            first = false;
-        } else {
-            // doesn't fit in the line
-            alignWordParts(lineStart, lineHeight);
+    _storedLayouts.insert(_storedLayouts.begin(), std::move(stored));
 
-            y += lineHeight;
+    if (_storedLayouts.size() > maxStoredLayouts) {
+        _storedLayouts.pop_back();
+    }
+}
 
-            _wordParts.push_back(
-                WordPart(word, MARGIN_LEFT, y - word.getHeight(), lineNumber, word.getCopyText()));
+uint MessageRef::getImageSizeHash()
+{
+    auto &settings = SettingsManager::getInstance();
 
-            lineStart = _wordParts.size() - 1;
+    int mediumTextLineHeight =
+        FontManager::getInstance().getFontMetrics(FontManager::Medium).height();
 
-            lineHeight = word.getHeight();
+    qreal emoteScale = settings.emoteScale.get();
+    bool scaleEmotesByLineHeight = settings.scaleEmotesByLineHeight.get();
 
-            x = word.getWidth() + MARGIN_LEFT;
-            x += spaceWidth;
+    uint32_t flags = settings.getWordTypeMask();
 
-            lineNumber++;
-        }
+    if (this->showChannelName) {
+        flags |= Word::ChannelName;
     }
 
-    alignWordParts(lineStart, lineHeight);
+    uint hash = 0;
 
-    if (_height != y + lineHeight) {
-        sizeChanged = true;
-        _height = y + lineHeight;
-    }
+    std::vector<Word> &words = _message->getWords();
 
-    if (sizeChanged) {
-        buffer = nullptr;
-    }
+    for (int i : _message->getShownWords(flags)) {
+        Word &word = words[i];
 
-    updateBuffer = true;
+        if (!word.isImage()) {
+            continue;
+        }
 
-    return true;
+        QSize size = getImageSize(word.getImage(), mediumTextLineHeight, emoteScale,
+                                  scaleEmotesByLineHeight);
+
+        hash = combineImageSize(hash, size.width(), size.height());
+    }
+
+    return hash;
 }
 
 const std::vector<WordPart> &MessageRef::getWordParts() const
@@ -228,15 +505,6 @@ const std::vector<WordPart> &MessageRef::getWordParts() const
     return _wordParts;
 }
 
-void MessageRef::alignWordParts(int lineStart, int lineHeight)
-{
-    for (size_t i = lineStart; i < _wordParts.size(); i++) {
-        WordPart &wordPart2 = _wordParts.at(i);
-
-        wordPart2.setY(wordPart2.getY() + lineHeight);
-    }
-}
-
 bool MessageRef::tryGetWordPart(QPoint point, Word &word)
 {
     // go through all words and return the first one that contains the point.
@@ -303,6 +571,9 @@ int MessageRef::getSelectionIndex(QPoint position)
         } else {
             auto text = part.getWord().getText();
 
+            GlyphAdvances &advances = TextMeasurer::getAdvances(
+                *FontManager::getInstance().getSnapshot(), part.getWord().getFontType());
+
             int x = part.getX();
 
             for (int j = 0; j < text.length(); j++) {
@@ -311,7 +582,7 @@ int MessageRef::getSelectionIndex(QPoint position)
                 }
 
                 index++;
-                x = part.getX() + part.getWord().getFontMetrics().width(text, j + 1);
+                x += advances.getAdvance(text, j);
             }
         }
 
@@ -5,6 +5,7 @@
 #include <QPixmap>
 
 #include <memory>
+#include <vector>
 
 namespace chatterino {
 namespace messages {
@@ -23,11 +24,87 @@ public:
 
     bool layout(int width, bool enableEmoteMargins = true);
 
+    // Laying out is split up so the expensive part can run on worker threads:
+    //   prepareLayout copies what the layout depends on out of the message (GUI thread)
+    //   computeLayout measures the text and positions the words (any thread)
+    //   applyLayout builds the word parts from the result (GUI thread)
+    // layout() does all three in one go.
+    struct LayoutWord {
+        // index in the message's words
+        int index;
+
+        bool isText;
+        bool needsMeasuring;
+        FontManager::Type font;
+        QString text;
+
+        int width;
+        int height;
+        int xOffset;
+    };
+
+    struct LayoutInput {
+        int width;
+        Word::Type wordTypes;
+        std::shared_ptr<const FontManager::Snapshot> fonts;
+
+        // only the words which are shown
+        std::vector<LayoutWord> words;
+    };
+
+    struct LayoutPart {
+        int wordIndex;
+
+        int x;
+        int y;
+        int width;
+        int height;
+        int lineNumber;
+
+        // pieces of words which were wrapped carry their own text
+        bool isPiece;
+        QString text;
+    };
+
+    struct LayoutResult {
+        int width;
+        int fontGeneration;
+        Word::Type wordTypes;
+
+        std::vector<LayoutWord> words;
+        std::vector<LayoutPart> parts;
+        int height;
+    };
+
+    LayoutInput prepareLayout(int width, bool enableEmoteMargins = true);
+    static LayoutResult computeLayout(LayoutInput input);
+
+    // Returns false if the result is outdated, i.e. the settings changed or the words were
+    // released while it was computed
+    bool applyLayout(const LayoutResult &result);
+
+    // Switches back to the layout for width if it was kept from before, i.e. while resizing back
+    // and forth. Returns false if there is none or it's outdated.
+    bool restoreLayout(int width);
+
+    // Whether the last layout is still up to date for the width, font and word types
+    bool isLayoutValid(int width) const;
+
+    // Whether the message shows the same words with wordTypes as with the current word type
+    // mask, i.e. none of the types which differ are present in the message
+    bool showsSameWords(Word::Type wordTypes) const;
+
     const std::vector<WordPart> &getWordParts() const;
 
     std::shared_ptr<QPixmap> buffer = nullptr;
     bool updateBuffer = false;
 
+    // whether the message was disabled when the buffer was drawn
+    bool bufferDisabled = false;
+
+    // merged splits show which channel each message is from
+    bool showChannelName = false;
+
     bool tryGetWordPart(QPoint point, messages::Word &word);
 
     int getSelectionIndex(QPoint position);
@@ -44,8 +121,29 @@ private:
     int _emoteGeneration = -1;
     Word::Type _currentWordTypes = Word::None;
 
+    // the shown images' sizes, they change when the images are loaded
+    uint _imageSizeHash = 0;
+
+    // the layouts at the last few other widths, most recent first
+    struct StoredLayout {
+        int width;
+        int fontGeneration;
+        Word::Type wordTypes;
+        uint imageSizeHash;
+
+        std::vector<WordPart> wordParts;
+        int height;
+
+        std::shared_ptr<QPixmap> buffer;
+        bool updateBuffer;
+        bool bufferDisabled;
+    };
+
+    std::vector<StoredLayout> _storedLayouts;
+
     // methods
-    void alignWordParts(int lineStart, int lineHeight);
+    void storeLayout();
+    uint getImageSizeHash();
 };
 
 }  // namespace messages
@@ -0,0 +1,138 @@
+#include "messages/searchindex.hpp"
+
+#include <algorithm>
+#include <iterator>
+
+namespace chatterino {
+namespace messages {
+
+namespace {
+
+// Shorter queries have no trigram and are checked against every message
+const int trigramLength = 3;
+
+}  // namespace
+
+void SearchIndex::addMessage(const SharedMessage &message)
+{
+    quint64 sequence = this->nextSequence++;
+
+    this->entries.push_back({sequence, message.get()});
+
+    for (quint64 trigram : getTrigrams(message->text)) {
+        this->postings[trigram].push_back(sequence);
+    }
+}
+
+void SearchIndex::removeOldestMessage(const SharedMessage &message)
+{
+    if (this->entries.empty() || this->entries.front().message != message.get()) {
+        return;
+    }
+
+    quint64 sequence = this->entries.front().sequence;
+    this->entries.pop_front();
+
+    // being the oldest message, it's at the front of all of its postings
+    for (quint64 trigram : getTrigrams(message->text)) {
+        auto posting = this->postings.find(trigram);
+
+        if (posting == this->postings.end() || posting.value().front() != sequence) {
+            continue;
+        }
+
+        posting.value().pop_front();
+
+        if (posting.value().empty()) {
+            this->postings.erase(posting);
+        }
+    }
+}
+
+std::vector<Message *> SearchIndex::search(const QString &text) const
+{
+    std::vector<Message *> results;
+
+    if (text.isEmpty() || this->entries.empty()) {
+        return results;
+    }
+
+    if (text.length() < trigramLength) {
+        for (const Entry &entry : this->entries) {
+            if (entry.message->text.contains(text, Qt::CaseInsensitive)) {
+                results.push_back(entry.message);
+            }
+        }
+
+        return results;
+    }
+
+    // start with the rarest trigram, so the candidate list is as short as possible
+    std::vector<const std::deque<quint64> *> lists;
+
+    for (quint64 trigram : getTrigrams(text)) {
+        auto posting = this->postings.find(trigram);
+
+        if (posting == this->postings.end()) {
+            return results;
+        }
+
+        lists.push_back(&posting.value());
+    }
+
+    std::sort(lists.begin(), lists.end(),
+              [](const std::deque<quint64> *a, const std::deque<quint64> *b) {
+                  return a->size() < b->size();
+              });
+
+    std::vector<quint64> candidates(lists[0]->begin(), lists[0]->end());
+
+    for (size_t i = 1; i < lists.size() && !candidates.empty(); i++) {
+        std::vector<quint64> intersection;
+
+        std::set_intersection(candidates.begin(), candidates.end(), lists[i]->begin(),
+                              lists[i]->end(), std::back_inserter(intersection));
+
+        candidates.swap(intersection);
+    }
+
+    // the trigrams may appear in a different order or apart from each other
+    quint64 firstSequence = this->entries.front().sequence;
+
+    for (quint64 sequence : candidates) {
+        Message *message = this->entries[sequence - firstSequence].message;
+
+        if (message->text.contains(text, Qt::CaseInsensitive)) {
+            results.push_back(message);
+        }
+    }
+
+    return results;
+}
+
+std::vector<quint64> SearchIndex::getTrigrams(const QString &text)
+{
+    std::vector<quint64> trigrams;
+
+    if (text.length() < trigramLength) {
+        return trigrams;
+    }
+
+    QString lowerText = text.toLower();
+    const QChar *data = lowerText.constData();
+
+    trigrams.reserve(lowerText.length() - trigramLength + 1);
+
+    for (int i = 0; i + trigramLength <= lowerText.length(); i++) {
+        trigrams.push_back((quint64(data[i].unicode()) << 32) |
+                           (quint64(data[i + 1].unicode()) << 16) | quint64(data[i + 2].unicode()));
+    }
+
+    std::sort(trigrams.begin(), trigrams.end());
+    trigrams.erase(std::unique(trigrams.begin(), trigrams.end()), trigrams.end());
+
+    return trigrams;
+}
+
+}  // namespace messages
+}  // namespace chatterino
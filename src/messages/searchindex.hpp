@@ -0,0 +1,50 @@
+#pragma once
+
+#include "messages/message.hpp"
+
+#include <QHash>
+#include <QString>
+
+#include <deque>
+#include <vector>
+
+namespace chatterino {
+namespace messages {
+
+// SearchIndex finds the messages of a channel containing a text without going through all of
+// them. Every message is split into trigrams (three lowercase characters), each trigram points to
+// the messages containing it. A query only checks the messages which contain all of its trigrams.
+//
+// Messages are added as they come in and removed oldest first, as they're removed from the
+// channel, so the postings stay sorted and are pruned from the front.
+//
+// Not thread safe, used in the GUI thread.
+class SearchIndex
+{
+public:
+    void addMessage(const SharedMessage &message);
+
+    // message must be the oldest message in the index
+    void removeOldestMessage(const SharedMessage &message);
+
+    // Messages containing text (case insensitive), oldest first
+    std::vector<Message *> search(const QString &text) const;
+
+private:
+    struct Entry {
+        quint64 sequence;
+        Message *message;
+    };
+
+    // oldest first, the sequence numbers have no gaps
+    std::deque<Entry> entries;
+    quint64 nextSequence = 0;
+
+    // trigram -> sequence numbers of the messages containing it, ascending
+    QHash<quint64, std::deque<quint64>> postings;
+
+    static std::vector<quint64> getTrigrams(const QString &text);
+};
+
+}  // namespace messages
+}  // namespace chatterino
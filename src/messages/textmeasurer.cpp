@@ -0,0 +1,49 @@
+#include "messages/textmeasurer.hpp"
+
+#include <QThreadStorage>
+
+#include <memory>
+#include <vector>
+
+namespace chatterino {
+namespace messages {
+
+namespace {
+
+struct ThreadAdvances {
+    int generation = -1;
+    std::vector<std::unique_ptr<GlyphAdvances>> advances;
+};
+
+// deleted by Qt when the thread exits
+QThreadStorage<ThreadAdvances *> threadAdvances;
+
+}  // namespace
+
+GlyphAdvances &TextMeasurer::getAdvances(const FontManager::Snapshot &fonts,
+                                         FontManager::Type type)
+{
+    if (!threadAdvances.hasLocalData()) {
+        threadAdvances.setLocalData(new ThreadAdvances);
+    }
+
+    ThreadAdvances *local = threadAdvances.localData();
+
+    if (local->generation != fonts.generation) {
+        local->generation = fonts.generation;
+        local->advances.clear();
+
+        for (const QFont &snapshotFont : fonts.fonts) {
+            // copies of a QFont share their data, ours must not be shared with the GUI thread
+            QFont font;
+            font.fromString(snapshotFont.toString());
+
+            local->advances.emplace_back(new GlyphAdvances(font));
+        }
+    }
+
+    return *local->advances.at(type);
+}
+
+}  // namespace messages
+}  // namespace chatterino
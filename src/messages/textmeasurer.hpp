@@ -0,0 +1,20 @@
+#pragma once
+
+#include "fontmanager.hpp"
+#include "messages/glyphadvances.hpp"
+
+namespace chatterino {
+namespace messages {
+
+// TextMeasurer hands out glyph advance tables owned by the calling thread. QFontMetrics is
+// reentrant, not thread safe, so layouts computed on worker threads as well as the GUI thread
+// measure their words through here instead of through the FontManager.
+class TextMeasurer
+{
+public:
+    // The tables are thrown away once a snapshot of a newer generation comes along
+    static GlyphAdvances &getAdvances(const FontManager::Snapshot &fonts, FontManager::Type type);
+};
+
+}  // namespace messages
+}  // namespace chatterino
@@ -0,0 +1,106 @@
+#include "messages/usermessagehistory.hpp"
+
+#include <algorithm>
+
+namespace chatterino {
+namespace messages {
+
+UserMessageHistory::UserMessageHistory(int _messagesPerUser, int _maxUsers)
+    : messagesPerUser(std::max(1, _messagesPerUser))
+    , maxUsers(std::max(1, _maxUsers))
+{
+}
+
+void UserMessageHistory::addMessage(const QString &userName, const QString &channelName,
+                                    const SharedMessage &message)
+{
+    auto iterator = this->users.find(userName);
+
+    if (iterator == this->users.end()) {
+        this->recentUsers.push_front(userName);
+
+        iterator = this->users.insert(userName, UserHistory());
+        iterator.value().recentPosition = this->recentUsers.begin();
+    } else {
+        // move to the front, the list iterator stays valid
+        this->recentUsers.splice(this->recentUsers.begin(), this->recentUsers,
+                                 iterator.value().recentPosition);
+    }
+
+    UserHistory &history = iterator.value();
+    Entry entry{channelName, message->text, QDateTime::currentDateTime()};
+
+    if (static_cast<int>(history.ring.size()) < this->messagesPerUser) {
+        history.ring.push_back(std::move(entry));
+    } else {
+        // overwrite the oldest entry
+        history.ring[history.start] = std::move(entry);
+        history.start = (history.start + 1) % history.ring.size();
+    }
+
+    // the new user is in front, so it's never the one dropped
+    this->trimUsers();
+}
+
+std::vector<UserMessageHistory::Entry> UserMessageHistory::getMessages(
+    const QString &userName) const
+{
+    auto iterator = this->users.find(userName);
+
+    if (iterator == this->users.end()) {
+        return {};
+    }
+
+    const UserHistory &history = iterator.value();
+
+    std::vector<Entry> entries;
+    entries.reserve(history.ring.size());
+
+    for (size_t i = 0; i < history.ring.size(); i++) {
+        entries.push_back(history.ring[(history.start + i) % history.ring.size()]);
+    }
+
+    return entries;
+}
+
+void UserMessageHistory::setLimits(int _messagesPerUser, int _maxUsers)
+{
+    _messagesPerUser = std::max(1, _messagesPerUser);
+
+    if (_messagesPerUser < this->messagesPerUser) {
+        // keep the newest messages of every user
+        for (UserHistory &history : this->users) {
+            if (static_cast<int>(history.ring.size()) <= _messagesPerUser) {
+                continue;
+            }
+
+            std::rotate(history.ring.begin(), history.ring.begin() + history.start,
+                        history.ring.end());
+            history.ring.erase(history.ring.begin(), history.ring.end() - _messagesPerUser);
+            history.start = 0;
+        }
+    } else if (_messagesPerUser > this->messagesPerUser) {
+        // full rings start growing again, which requires them to start at index 0
+        for (UserHistory &history : this->users) {
+            std::rotate(history.ring.begin(), history.ring.begin() + history.start,
+                        history.ring.end());
+            history.start = 0;
+        }
+    }
+
+    this->messagesPerUser = _messagesPerUser;
+    this->maxUsers = std::max(1, _maxUsers);
+
+    this->trimUsers();
+}
+
+void UserMessageHistory::trimUsers()
+{
+    while (static_cast<int>(this->recentUsers.size()) > this->maxUsers) {
+        this->users.remove(this->recentUsers.back());
+        this->recentUsers.pop_back();
+    }
+}
+
+}  // namespace messages
+}  // namespace chatterino
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "messages/message.hpp"
+
+#include <QDateTime>
+#include <QHash>
+#include <QString>
+
+#include <list>
+#include <vector>
+
+namespace chatterino {
+namespace messages {
+
+// UserMessageHistory keeps the last messages of every user, across all channels, so they can be
+// shown right away without going through the scrollback of each channel.
+//
+// Each user has a ring of at most messagesPerUser messages. Once more than maxUsers users are
+// tracked, the one who didn't write for the longest time is dropped. Only the text of a message is
+// kept, never the Message itself, so the history doesn't keep messages alive after the channels
+// dropped them and its memory is capped at maxUsers * messagesPerUser texts.
+//
+// Not thread safe, messages are added in the GUI thread.
+class UserMessageHistory
+{
+public:
+    struct Entry {
+        QString channelName;
+        QString text;
+        QDateTime time;
+    };
+
+    UserMessageHistory(int messagesPerUser, int maxUsers);
+
+    void addMessage(const QString &userName, const QString &channelName,
+                    const SharedMessage &message);
+
+    // Oldest first
+    std::vector<Entry> getMessages(const QString &userName) const;
+
+    void setLimits(int messagesPerUser, int maxUsers);
+
+private:
+    struct UserHistory {
+        std::vector<Entry> ring;
+
+        // index of the oldest entry once the ring is full
+        size_t start = 0;
+
+        // position in recentUsers
+        std::list<QString>::iterator recentPosition;
+    };
+
+    int messagesPerUser;
+    int maxUsers;
+
+    QHash<QString, UserHistory> users;
+
+    // most recently active first
+    std::list<QString> recentUsers;
+
+    void trimUsers();
+};
+
+}  // namespace messages
+}  // namespace chatterino
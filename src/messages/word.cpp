@@ -14,7 +14,6 @@ Word::Word(LazyLoadedImage *image, Type type, const QString &copytext, const QSt
     , _copyText(copytext)
     , _tooltip(tooltip)
     , _link(link)
-    , _characterWidthCache()
 {
     image->getWidth();  // professional segfault test
 }
@@ -30,7 +29,6 @@ Word::Word(const QString &text, Type type, const QColor &color, const QString &c
     , _copyText(copytext)
     , _tooltip(tooltip)
     , _link(link)
-    , _characterWidthCache()
 {
 }
 
@@ -90,6 +88,11 @@ QFontMetrics &Word::getFontMetrics() const
     return FontManager::getInstance().getFontMetrics(_font);
 }
 
+FontManager::Type Word::getFontType() const
+{
+    return _font;
+}
+
 Word::Type Word::getType() const
 {
     return _type;
@@ -126,10 +129,5 @@ void Word::setOffset(int xOffset, int yOffset)
     _yOffset = std::max(0, yOffset);
 }
 
-std::vector<short> &Word::getCharacterWidthCache() const
-{
-    return _characterWidthCache;
-}
-
 }  // namespace messages
 }  // namespace chatterino
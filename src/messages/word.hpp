@@ -77,6 +77,9 @@ public:
         EmojiImage = (1 << 23),
         EmojiText = (1 << 24),
 
+        // only shown in splits merging several channels
+        ChannelName = (1 << 25),
+
         Default = TimestampNoSeconds | Badges | Username | BitsStatic | FfzEmoteImage |
                   BttvEmoteImage | BttvGifEmoteImage | TwitchEmoteImage | BitsAmount | Text |
                   ButtonBan | ButtonTimeout
@@ -103,6 +106,7 @@ public:
     bool hasTrailingSpace() const;
     QFont &getFont() const;
     QFontMetrics &getFontMetrics() const;
+    FontManager::Type getFontType() const;
     Type getType() const;
     const QString &getTooltip() const;
     const QColor &getColor() const;
@@ -111,8 +115,6 @@ public:
     int getYOffset() const;
     void setOffset(int _xOffset, int _yOffset);
 
-    std::vector<short> &getCharacterWidthCache() const;
-
 private:
     LazyLoadedImage *_image;
     QString _text;
@@ -131,8 +133,6 @@ private:
     bool _hasTrailingSpace;
     FontManager::Type _font = FontManager::Medium;
     Link _link;
-
-    mutable std::vector<short> _characterWidthCache;
 };
 
 }  // namespace messages
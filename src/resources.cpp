@@ -110,4 +110,21 @@ void Resources::loadChannelData(const std::string &roomID, bool bypassCache)
     });
 }
 
+void Resources::unloadChannelBadges(const std::string &roomID)
+{
+    auto channel = this->channels.find(roomID);
+
+    if (channel == this->channels.end()) {
+        return;
+    }
+
+    for (auto &badgeSet : channel->second.badgeSets) {
+        for (auto &version : badgeSet.second.versions) {
+            version.second.badgeImage1x->unload();
+            version.second.badgeImage2x->unload();
+            version.second.badgeImage4x->unload();
+        }
+    }
+}
+
 }  // namespace chatterino
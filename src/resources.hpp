@@ -72,6 +72,9 @@ public:
     std::map<std::string, Channel> channels;
 
     void loadChannelData(const std::string &roomID, bool bypassCache = false);
+
+    // Unloads the images of the channel's badges, they're loaded again once they're drawn
+    void unloadChannelBadges(const std::string &roomID);
 };
 
 }  // namespace chatterino
@@ -14,6 +14,10 @@ SettingsManager::SettingsManager()
     , showTimestamps("/appearance/messages/showTimestamps", true)
     , showTimestampSeconds("/appearance/messages/showTimestampSeconds", true)
     , showBadges("/appearance/messages/showBadges", true)
+    , ircServerHost("/connection/twitch/host", "irc.chat.twitch.tv")
+    , ircServerPort("/connection/twitch/port", 6667)
+    , twitchApiBaseUrl("/connection/twitch/apiBaseUrl", "https://api.twitch.tv/kraken")
+    , ircReadConnectionCount("/connection/twitch/readConnectionCount", 1)
     , selectedUser(_settingsItems, "selectedUser", "")
     , emoteScale(_settingsItems, "emoteScale", 1.0)
     , mouseScrollMultiplier(_settingsItems, "mouseScrollMultiplier", 1.0)
@@ -42,6 +46,15 @@ SettingsManager::SettingsManager()
     , hidePreferencesButton(_settingsItems, "hidePreferencesButton", false)
     , hideUserButton(_settingsItems, "hideUserButton", false)
     , useCustomWindowFrame(_settingsItems, "useCustomWindowFrame", true)
+    , ignoredPhrases(_settingsItems, "ignoredPhrases", "")
+    , ignoredEmotes(_settingsItems, "ignoredEmotes", "")
+    , highlightPhrases(_settingsItems, "highlightPhrases", "")
+    , highlightRegexes(_settingsItems, "highlightRegexes", "")
+    , userHistoryMessageCount(_settingsItems, "userHistoryMessageCount", 20)
+    , userHistoryUserCount(_settingsItems, "userHistoryUserCount", 5000)
+    , enableFastChatThrottling(_settingsItems, "enableFastChatThrottling", true)
+    , hibernateChannelsAfter(_settingsItems, "hibernateChannelsAfter", 10)
+    , enableLogging(_settingsItems, "enableLogging", false)
 {
     this->showTimestamps.getValueChangedSignal().connect(
         [this](const auto &) { this->updateWordTypeMask(); });
@@ -56,6 +69,8 @@ SettingsManager::SettingsManager()
         [this](const auto &) { this->updateWordTypeMask(); });
     this->enableTwitchEmotes.valueChanged.connect(
         [this](const auto &) { this->updateWordTypeMask(); });
+    this->ignoredEmotes.valueChanged.connect(
+        [this](const auto &) { this->updateIgnoredEmotes(); });
 }
 
 void SettingsManager::save()
@@ -77,9 +92,9 @@ Word::Type SettingsManager::getWordTypeMask()
     return _wordTypeMask;
 }
 
-bool SettingsManager::isIgnoredEmote(const QString &)
+bool SettingsManager::isIgnoredEmote(const QString &emote)
 {
-    return false;
+    return _ignoredEmotes.contains(emote);
 }
 
 QSettings &SettingsManager::getQSettings()
@@ -124,6 +139,19 @@ void SettingsManager::updateWordTypeMask()
     }
 }
 
+void SettingsManager::updateIgnoredEmotes()
+{
+    _ignoredEmotes.clear();
+
+    for (const QString &line : this->ignoredEmotes.get().split('\n', QString::SkipEmptyParts)) {
+        QString emote = line.trimmed();
+
+        if (!emote.isEmpty()) {
+            _ignoredEmotes.insert(emote);
+        }
+    }
+}
+
 SettingsSnapshot SettingsManager::createSnapshot()
 {
     SettingsSnapshot snapshot;
@@ -4,6 +4,7 @@
 #include "setting.hpp"
 #include "settingssnapshot.hpp"
 
+#include <QSet>
 #include <QSettings>
 #include <pajlada/settings/setting.hpp>
 
@@ -32,10 +33,12 @@ private:
     QSettings _settings;
     std::vector<std::reference_wrapper<BaseSetting>> _settingsItems;
     messages::Word::Type _wordTypeMask = messages::Word::Default;
+    QSet<QString> _ignoredEmotes;
 
     // methods
 public: // temporary
     void updateWordTypeMask();
+    void updateIgnoredEmotes();
 
 public:
     // new pajlada settings BBaper
@@ -43,6 +46,16 @@ public:
     pajlada::Settings::Setting<bool> showTimestampSeconds;
     pajlada::Settings::Setting<bool> showBadges;
 
+    // Twitch IRC server to connect to, override to point chatterino at tools/fakeircserver
+    pajlada::Settings::Setting<std::string> ircServerHost;
+    pajlada::Settings::Setting<int> ircServerPort;
+
+    // Twitch API used for the block list, override to point chatterino at a local stand-in
+    pajlada::Settings::Setting<std::string> twitchApiBaseUrl;
+
+    // Number of connections the joined channels are spread across
+    pajlada::Settings::Setting<int> ircReadConnectionCount;
+
     // Settings
     Setting<QString> selectedUser;
     Setting<float> emoteScale;
@@ -73,6 +86,28 @@ public:
     Setting<bool> hideUserButton;
     Setting<bool> useCustomWindowFrame;
 
+    // One phrase/emote per line, messages containing any of them are dropped when received
+    Setting<QString> ignoredPhrases;
+    Setting<QString> ignoredEmotes;
+
+    // One per line, besides the user's own name
+    Setting<QString> highlightPhrases;
+    Setting<QString> highlightRegexes;
+
+    // Recent messages kept per user for the user popup, and the number of users they're kept
+    // for. Together they cap the memory used.
+    Setting<int> userHistoryMessageCount;
+    Setting<int> userHistoryUserCount;
+
+    // Limit the frame rate of splits which can't keep up with their chat, see ChatWidget
+    Setting<bool> enableFastChatThrottling;
+
+    // Minutes after which channels that aren't shown hibernate, 0 to never hibernate
+    Setting<int> hibernateChannelsAfter;
+
+    // Write the messages of all channels to log files, which the global search can include
+    Setting<bool> enableLogging;
+
 public:
     static SettingsManager &getInstance()
     {
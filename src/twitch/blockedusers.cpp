@@ -0,0 +1,213 @@
+#include "twitch/blockedusers.hpp"
+#include "settingsmanager.hpp"
+
+#include <QDebug>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QNetworkReply>
+#include <QUrl>
+
+#include <atomic>
+
+namespace chatterino {
+namespace twitch {
+
+namespace {
+
+const int pageSize = 100;
+
+// in case the API keeps handing out next links
+const int maxPages = 1000;
+
+}  // namespace
+
+BlockedUsers::BlockedUsers()
+    : users(std::unique_ptr<const QSet<QByteArray>>(new QSet<QByteArray>()))
+{
+}
+
+bool BlockedUsers::isBlocked(const QString &username) const
+{
+    util::RcuPointer<QSet<QByteArray>>::ReadGuard currentUsers(this->users);
+
+    return currentUsers->contains(username.toUtf8());
+}
+
+bool BlockedUsers::isBlocked(const util::ByteView &username) const
+{
+    util::RcuPointer<QSet<QByteArray>>::ReadGuard currentUsers(this->users);
+
+    // fromRawData doesn't copy, the view outlives the lookup
+    return currentUsers->contains(
+        QByteArray::fromRawData(username.getData(), username.getSize()));
+}
+
+void BlockedUsers::refresh(const TwitchUser &account)
+{
+    int generation = ++this->refreshGeneration;
+
+    if (account.isAnon()) {
+        this->setUsers(std::unique_ptr<const QSet<QByteArray>>(new QSet<QByteArray>()));
+        return;
+    }
+
+    QString url = getApiBaseUrl() + "/users/" + account.getUserName() +
+                  "/blocks?limit=" + QString::number(pageSize);
+
+    this->fetchPage(account, url, generation, 0, std::make_shared<QSet<QByteArray>>());
+}
+
+void BlockedUsers::block(const TwitchUser &account, const QString &username, Callback callback)
+{
+    this->sendChange(account, username.toLower(), true, callback);
+}
+
+void BlockedUsers::unblock(const TwitchUser &account, const QString &username, Callback callback)
+{
+    this->sendChange(account, username.toLower(), false, callback);
+}
+
+void BlockedUsers::fetchPage(const TwitchUser &account, const QString &url, int generation,
+                             int page, std::shared_ptr<QSet<QByteArray>> result)
+{
+    QNetworkReply *reply = this->networkAccessManager.get(createRequest(account, url));
+
+    QObject::connect(reply, &QNetworkReply::finished, this, [=] {
+        reply->deleteLater();
+
+        if (generation != this->refreshGeneration) {
+            // a newer refresh was started
+            return;
+        }
+
+        if (reply->error() != QNetworkReply::NoError) {
+            qDebug() << "[BlockedUsers] Error fetching blocked users:" << reply->errorString();
+            return;
+        }
+
+        QJsonObject root = QJsonDocument::fromJson(reply->readAll()).object();
+        QJsonArray blocks = root.value("blocks").toArray();
+
+        for (const QJsonValue &block : blocks) {
+            QJsonObject user = block.toObject().value("user").toObject();
+
+            result->insert(user.value("name").toString().toLower().toUtf8());
+        }
+
+        QString nextLink = root.value("_links").toObject().value("next").toString();
+
+        if (!blocks.isEmpty() && !nextLink.isEmpty() && page + 1 < maxPages) {
+            this->fetchPage(account, nextLink, generation, page + 1, result);
+            return;
+        }
+
+        // blocks and unblocks which are still in flight win over the fetched list
+        for (auto it = this->pendingChanges.begin(); it != this->pendingChanges.end(); ++it) {
+            if (it.value().blocked) {
+                result->insert(it.key().toUtf8());
+            } else {
+                result->remove(it.key().toUtf8());
+            }
+        }
+
+        qDebug() << "[BlockedUsers] Loaded" << result->size() << "blocked users";
+
+        this->setUsers(
+            std::unique_ptr<const QSet<QByteArray>>(new QSet<QByteArray>(std::move(*result))));
+    });
+}
+
+void BlockedUsers::sendChange(const TwitchUser &account, const QString &username, bool blocked,
+                              Callback callback)
+{
+    // optimistic update, rolled back if the request fails
+    this->setBlocked(username, blocked);
+
+    int sequence = ++this->changeSequence;
+    this->pendingChanges.insert(username, {blocked, sequence});
+
+    QNetworkRequest request = createRequest(
+        account, getApiBaseUrl() + "/users/" + account.getUserName() + "/blocks/" + username);
+
+    QNetworkReply *reply = blocked ? this->networkAccessManager.put(request, QByteArray())
+                                   : this->networkAccessManager.deleteResource(request);
+
+    QObject::connect(reply, &QNetworkReply::finished, this, [=] {
+        reply->deleteLater();
+
+        // a newer change of the same user is in flight, that one decides
+        auto pending = this->pendingChanges.find(username);
+        bool isLatestChange =
+            pending != this->pendingChanges.end() && pending.value().sequence == sequence;
+
+        if (isLatestChange) {
+            this->pendingChanges.erase(pending);
+        }
+
+        if (reply->error() != QNetworkReply::NoError) {
+            if (isLatestChange) {
+                this->setBlocked(username, !blocked);
+            }
+
+            QString errorMessage = QString("Error while %1 user \"%2\": %3")
+                                       .arg(blocked ? "ignoring" : "unignoring", username,
+                                            reply->errorString());
+
+            qDebug() << "[BlockedUsers]" << errorMessage;
+
+            if (callback) {
+                callback(false, errorMessage);
+            }
+
+            return;
+        }
+
+        if (callback) {
+            callback(true, QString());
+        }
+    });
+}
+
+void BlockedUsers::setBlocked(const QString &username, bool blocked)
+{
+    util::RcuPointer<QSet<QByteArray>>::ReadGuard currentUsers(this->users);
+    QByteArray name = username.toUtf8();
+
+    if (currentUsers->contains(name) == blocked) {
+        return;
+    }
+
+    // copy on write, readers keep using the old set until they're done with it
+    std::unique_ptr<QSet<QByteArray>> newUsers(new QSet<QByteArray>(*currentUsers));
+
+    if (blocked) {
+        newUsers->insert(name);
+    } else {
+        newUsers->remove(name);
+    }
+
+    this->setUsers(std::move(newUsers));
+}
+
+void BlockedUsers::setUsers(std::unique_ptr<const QSet<QByteArray>> newUsers)
+{
+    this->users.publish(std::move(newUsers));
+}
+
+QString BlockedUsers::getApiBaseUrl()
+{
+    return QString::fromStdString(SettingsManager::getInstance().twitchApiBaseUrl.getValue());
+}
+
+QNetworkRequest BlockedUsers::createRequest(const TwitchUser &account, const QString &url)
+{
+    QNetworkRequest request{QUrl(url)};
+
+    request.setRawHeader("Client-ID", account.getOAuthClient().toUtf8());
+    request.setRawHeader("Authorization", "OAuth " + account.getOAuthToken().toUtf8());
+
+    return request;
+}
+
+}  // namespace twitch
+}  // namespace chatterino
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "twitch/twitchuser.hpp"
+#include "util/byteview.hpp"
+#include "util/rcupointer.hpp"
+
+#include <QHash>
+#include <QNetworkAccessManager>
+#include <QNetworkRequest>
+#include <QObject>
+#include <QSet>
+#include <QString>
+
+#include <functional>
+#include <memory>
+
+namespace chatterino {
+namespace twitch {
+
+// BlockedUsers keeps the list of users the account has blocked on Twitch.
+//
+// Lookups are lock free (the set is published through an RcuPointer), so isBlocked can be called
+// for every received message from any thread. Everything else must be called from the GUI thread;
+// the API calls never block, blocking and unblocking are applied locally right away and rolled
+// back if the API call fails.
+class BlockedUsers : public QObject
+{
+    Q_OBJECT
+
+public:
+    using Callback = std::function<void(bool success, const QString &errorMessage)>;
+
+    BlockedUsers();
+
+    // username must be lowercase, just like the logins in IRC prefixes
+    bool isBlocked(const QString &username) const;
+    bool isBlocked(const util::ByteView &username) const;
+
+    // Fetches all pages of the block list, replaces the current list once done
+    void refresh(const TwitchUser &account);
+
+    void block(const TwitchUser &account, const QString &username, Callback callback = nullptr);
+    void unblock(const TwitchUser &account, const QString &username, Callback callback = nullptr);
+
+private:
+    QNetworkAccessManager networkAccessManager;
+
+    // UTF-8 encoded, so nicks straight from the receive buffer can be looked up without copying
+    util::RcuPointer<QSet<QByteArray>> users;
+
+    struct PendingChange {
+        bool blocked;
+
+        // identifies the latest call for the user, only that one may roll back or clear it
+        int sequence;
+    };
+
+    // block/unblock calls still in flight, re-applied on top of a refreshed list
+    QHash<QString, PendingChange> pendingChanges;
+    int changeSequence = 0;
+
+    // results of an outdated refresh are dropped
+    int refreshGeneration = 0;
+
+    void fetchPage(const TwitchUser &account, const QString &url, int generation, int page,
+                   std::shared_ptr<QSet<QByteArray>> result);
+    void sendChange(const TwitchUser &account, const QString &username, bool blocked,
+                    Callback callback);
+
+    void setBlocked(const QString &username, bool blocked);
+    void setUsers(std::unique_ptr<const QSet<QByteArray>> newUsers);
+
+    static QString getApiBaseUrl();
+    static QNetworkRequest createRequest(const TwitchUser &account, const QString &url);
+};
+
+}  // namespace twitch
+}  // namespace chatterino
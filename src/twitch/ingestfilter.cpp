@@ -0,0 +1,133 @@
+#include "twitch/ingestfilter.hpp"
+#include "twitch/blockedusers.hpp"
+
+#include <QHash>
+#include <QStringList>
+
+namespace chatterino {
+namespace twitch {
+
+IngestFilter::IngestFilter(BlockedUsers &_blockedUsers)
+    : blockedUsers(_blockedUsers)
+    , blockedUserHits(0)
+    , rules(std::unique_ptr<const Rules>(new Rules()))
+{
+}
+
+bool IngestFilter::shouldDrop(const RawIrcMessage &message) const
+{
+    util::ByteView command = message.getCommand();
+
+    if (command == "WHISPER") {
+        return this->isFromBlockedUser(message.getNick());
+    }
+
+    // subs and resubs come from tmi.twitch.tv, the user is in the login tag
+    if (command == "USERNOTICE") {
+        util::ByteView login = message.getRawTag("login");
+
+        return !login.isEmpty() && this->isFromBlockedUser(login);
+    }
+
+    if (command != "PRIVMSG") {
+        return false;
+    }
+
+    if (this->isFromBlockedUser(message.getNick())) {
+        return true;
+    }
+
+    util::RcuPointer<Rules>::ReadGuard currentRules(this->rules);
+
+    if (currentRules->matcher.isEmpty()) {
+        return false;
+    }
+
+    util::ByteView content = message.getContent();
+    int rule = currentRules->matcher.findFirst(content.getData(), content.getSize());
+
+    if (rule == -1) {
+        return false;
+    }
+
+    currentRules->hits[rule]++;
+
+    return true;
+}
+
+void IngestFilter::setRules(const QString &ignoredPhrases, const QString &ignoredEmotes)
+{
+    // keep the hit counts of rules which didn't change
+    QHash<QString, quint64> oldHits;
+
+    {
+        util::RcuPointer<Rules>::ReadGuard oldRules(this->rules);
+
+        for (size_t i = 0; i < oldRules->names.size(); i++) {
+            oldHits.insert(oldRules->names[i], oldRules->hits[i]);
+        }
+    }
+
+    std::vector<util::MultiPatternMatcher::Pattern> patterns;
+    std::unique_ptr<Rules> newRules(new Rules());
+
+    auto addRules = [&](const QString &list, const QString &prefix,
+                        util::MultiPatternMatcher::Boundary boundary) {
+        for (const QString &line : list.split('\n', QString::SkipEmptyParts)) {
+            QString text = line.trimmed();
+
+            if (text.isEmpty()) {
+                continue;
+            }
+
+            util::MultiPatternMatcher::Pattern pattern;
+            pattern.text = text.toUtf8();
+            pattern.boundary = boundary;
+
+            patterns.push_back(pattern);
+            newRules->names.push_back(prefix + text);
+        }
+    };
+
+    addRules(ignoredPhrases, "phrase: ", util::MultiPatternMatcher::Boundary::None);
+
+    // emotes are single words
+    addRules(ignoredEmotes, "emote: ", util::MultiPatternMatcher::Boundary::Space);
+
+    newRules->matcher = util::MultiPatternMatcher(patterns);
+    newRules->hits.reset(new std::atomic<quint64>[newRules->names.size()]);
+
+    for (size_t i = 0; i < newRules->names.size(); i++) {
+        newRules->hits[i] = oldHits.value(newRules->names[i], 0);
+    }
+
+    this->rules.publish(std::move(newRules));
+}
+
+bool IngestFilter::isFromBlockedUser(const util::ByteView &login) const
+{
+    if (!this->blockedUsers.isBlocked(login)) {
+        return false;
+    }
+
+    this->blockedUserHits++;
+
+    return true;
+}
+
+std::vector<IngestFilter::RuleStatistics> IngestFilter::getStatistics() const
+{
+    util::RcuPointer<Rules>::ReadGuard currentRules(this->rules);
+
+    std::vector<RuleStatistics> statistics;
+    statistics.push_back({"blocked users", this->blockedUserHits});
+
+    for (size_t i = 0; i < currentRules->names.size(); i++) {
+        statistics.push_back({currentRules->names[i], currentRules->hits[i]});
+    }
+
+    return statistics;
+}
+
+}  // namespace twitch
+}  // namespace chatterino
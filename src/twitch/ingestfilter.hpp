@@ -0,0 +1,62 @@
+#pragma once
+
+#include "twitch/rawircmessage.hpp"
+#include "util/multipatternmatcher.hpp"
+#include "util/rcupointer.hpp"
+
+#include <QString>
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace chatterino {
+namespace twitch {
+
+class BlockedUsers;
+
+// IngestFilter decides whether a received message is dropped before a Message is ever built for
+// it. It works on the raw line in the I/O thread: messages, whispers and sub notices from blocked
+// users, and messages containing an ignored phrase or an ignored emote are dropped.
+//
+// All phrases and emotes are compiled into one MultiPatternMatcher, so the cost of checking a
+// message doesn't grow with the number of rules.
+class IngestFilter
+{
+public:
+    struct RuleStatistics {
+        QString rule;
+        quint64 hits;
+    };
+
+    explicit IngestFilter(BlockedUsers &_blockedUsers);
+
+    // Can be called from any thread
+    bool shouldDrop(const RawIrcMessage &message) const;
+
+    // Phrases and emotes are separated by newlines. Rules which stay the same keep their hit
+    // counters. Must be called from the GUI thread.
+    void setRules(const QString &ignoredPhrases, const QString &ignoredEmotes);
+
+    // Can be called from any thread
+    std::vector<RuleStatistics> getStatistics() const;
+
+private:
+    struct Rules {
+        util::MultiPatternMatcher matcher;
+
+        // one per pattern of the matcher
+        std::vector<QString> names;
+        std::unique_ptr<std::atomic<quint64>[]> hits;
+    };
+
+    BlockedUsers &blockedUsers;
+    mutable std::atomic<quint64> blockedUserHits;
+
+    bool isFromBlockedUser(const util::ByteView &login) const;
+
+    util::RcuPointer<Rules> rules;
+};
+
+}  // namespace twitch
+}  // namespace chatterino
@@ -0,0 +1,289 @@
+#include "twitch/rawircmessage.hpp"
+
+using namespace chatterino::util;
+
+namespace chatterino {
+namespace twitch {
+
+bool RawIrcMessage::parse(const QByteArray &line, RawIrcMessage &message)
+{
+    return parse(line, 0, line.size(), message);
+}
+
+bool RawIrcMessage::parse(const QByteArray &buffer, int start, int length, RawIrcMessage &message)
+{
+    // share the buffer first, all views point into our own copy
+    message.buffer = buffer;
+    message.prefix = ByteView();
+    message.command = ByteView();
+    message.parameters.clear();
+    message.tags.clear();
+
+    const char *data = message.buffer.constData() + start;
+    ByteView rest(data, length);
+
+    message.line = rest;
+
+    int position = 0;
+
+    // tags
+    if (rest.startsWith('@')) {
+        int tagsEnd = rest.indexOf(' ');
+
+        if (tagsEnd == -1) {
+            return false;
+        }
+
+        int tagStart = 1;
+
+        while (tagStart < tagsEnd) {
+            int tagEnd = rest.indexOf(';', tagStart);
+
+            if (tagEnd == -1 || tagEnd > tagsEnd) {
+                tagEnd = tagsEnd;
+            }
+
+            ByteView tag = rest.mid(tagStart, tagEnd - tagStart);
+            int equals = tag.indexOf('=');
+
+            Tag parsedTag;
+
+            if (equals == -1) {
+                parsedTag.key = tag;
+            } else {
+                parsedTag.key = tag.left(equals);
+                parsedTag.value = tag.mid(equals + 1);
+            }
+
+            if (!parsedTag.key.isEmpty()) {
+                message.tags.append(parsedTag);
+            }
+
+            tagStart = tagEnd + 1;
+        }
+
+        position = tagsEnd + 1;
+    }
+
+    while (position < length && data[position] == ' ') {
+        position++;
+    }
+
+    // prefix
+    if (position < length && data[position] == ':') {
+        int prefixEnd = rest.indexOf(' ', position);
+
+        if (prefixEnd == -1) {
+            return false;
+        }
+
+        message.prefix = rest.mid(position + 1, prefixEnd - position - 1);
+        position = prefixEnd + 1;
+
+        while (position < length && data[position] == ' ') {
+            position++;
+        }
+    }
+
+    // command
+    int commandEnd = rest.indexOf(' ', position);
+
+    if (commandEnd == -1) {
+        commandEnd = length;
+    }
+
+    message.command = rest.mid(position, commandEnd - position);
+
+    if (message.command.isEmpty()) {
+        return false;
+    }
+
+    position = commandEnd + 1;
+
+    // parameters
+    while (position < length) {
+        if (data[position] == ' ') {
+            position++;
+            continue;
+        }
+
+        if (data[position] == ':') {
+            message.parameters.append(rest.mid(position + 1));
+            break;
+        }
+
+        int parameterEnd = rest.indexOf(' ', position);
+
+        if (parameterEnd == -1) {
+            parameterEnd = length;
+        }
+
+        message.parameters.append(rest.mid(position, parameterEnd - position));
+        position = parameterEnd + 1;
+    }
+
+    return true;
+}
+
+ByteView RawIrcMessage::getLine() const
+{
+    return this->line;
+}
+
+ByteView RawIrcMessage::getPrefix() const
+{
+    return this->prefix;
+}
+
+ByteView RawIrcMessage::getNick() const
+{
+    int index = this->prefix.indexOf('!');
+
+    if (index == -1) {
+        return this->prefix;
+    }
+
+    return this->prefix.left(index);
+}
+
+ByteView RawIrcMessage::getCommand() const
+{
+    return this->command;
+}
+
+int RawIrcMessage::getParameterCount() const
+{
+    return this->parameters.size();
+}
+
+ByteView RawIrcMessage::getParameter(int index) const
+{
+    if (index < 0 || index >= this->parameters.size()) {
+        return ByteView();
+    }
+
+    return this->parameters[index];
+}
+
+ByteView RawIrcMessage::getTarget() const
+{
+    return this->getParameter(0);
+}
+
+QString RawIrcMessage::getChannelName() const
+{
+    ByteView target = this->getTarget();
+
+    if (target.startsWith('#')) {
+        return target.mid(1).toString();
+    }
+
+    return target.toString();
+}
+
+ByteView RawIrcMessage::getContent() const
+{
+    if (this->parameters.isEmpty()) {
+        return ByteView();
+    }
+
+    return this->parameters.last();
+}
+
+QString RawIrcMessage::getMessageText() const
+{
+    ByteView content = this->getContent();
+
+    if (this->isAction()) {
+        // strip "\x01ACTION " and the trailing "\x01"
+        return content.mid(8, content.getSize() - 9).toString();
+    }
+
+    return content.toString();
+}
+
+bool RawIrcMessage::isAction() const
+{
+    ByteView content = this->getContent();
+
+    // "\x01" and "ACTION" are split, otherwise \x01A is read as a single escape sequence
+    return content.getSize() >= 9 && content.startsWith("\x01"
+                                                        "ACTION ") &&
+           content.endsWith('\x01');
+}
+
+const RawIrcMessage::TagList &RawIrcMessage::getTags() const
+{
+    return this->tags;
+}
+
+bool RawIrcMessage::hasTag(const char *key) const
+{
+    for (const Tag &tag : this->tags) {
+        if (tag.key == key) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+ByteView RawIrcMessage::getRawTag(const char *key) const
+{
+    for (const Tag &tag : this->tags) {
+        if (tag.key == key) {
+            return tag.value;
+        }
+    }
+
+    return ByteView();
+}
+
+QString RawIrcMessage::getTag(const char *key) const
+{
+    return unescapeTagValue(this->getRawTag(key));
+}
+
+QString RawIrcMessage::unescapeTagValue(const ByteView &value)
+{
+    if (value.indexOf('\\') == -1) {
+        return value.toString();
+    }
+
+    QByteArray unescaped;
+    unescaped.reserve(value.getSize());
+
+    for (int i = 0; i < value.getSize(); i++) {
+        char c = value.at(i);
+
+        if (c != '\\' || i + 1 == value.getSize()) {
+            unescaped.append(c);
+            continue;
+        }
+
+        char next = value.at(++i);
+
+        switch (next) {
+            case ':':
+                unescaped.append(';');
+                break;
+            case 's':
+                unescaped.append(' ');
+                break;
+            case 'r':
+                unescaped.append('\r');
+                break;
+            case 'n':
+                unescaped.append('\n');
+                break;
+            default:
+                unescaped.append(next);
+                break;
+        }
+    }
+
+    return QString::fromUtf8(unescaped);
+}
+
+}  // namespace twitch
+}  // namespace chatterino
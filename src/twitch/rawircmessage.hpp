@@ -0,0 +1,78 @@
+#pragma once
+
+#include "util/byteview.hpp"
+
+#include <QByteArray>
+#include <QString>
+#include <QVarLengthArray>
+
+namespace chatterino {
+namespace twitch {
+
+// RawIrcMessage is a parsed IRC line, as sent by Twitch:
+//   @tag1=value;tag2=value :nick!user@host COMMAND param1 param2 :trailing param
+//
+// It's a value type: all parts of the message are views into the (implicitly shared) receive
+// buffer, so parsing a line doesn't allocate unless it has an unusual amount of tags or params.
+class RawIrcMessage
+{
+public:
+    struct Tag {
+        util::ByteView key;
+        util::ByteView value;
+    };
+
+    using TagList = QVarLengthArray<Tag, 24>;
+
+    RawIrcMessage() = default;
+
+    // Parses the line at [start, start + length) of buffer. The line must not contain the trailing
+    // \r\n. Returns false if the line isn't a valid IRC message.
+    static bool parse(const QByteArray &buffer, int start, int length, RawIrcMessage &message);
+    static bool parse(const QByteArray &line, RawIrcMessage &message);
+
+    util::ByteView getLine() const;
+
+    util::ByteView getPrefix() const;
+    util::ByteView getNick() const;
+    util::ByteView getCommand() const;
+
+    int getParameterCount() const;
+    util::ByteView getParameter(int index) const;
+
+    // First parameter, i.e. the channel for most commands
+    util::ByteView getTarget() const;
+
+    // Channel name of the first parameter, without the leading #
+    QString getChannelName() const;
+
+    // Last parameter, i.e. the text of a PRIVMSG
+    util::ByteView getContent() const;
+
+    // Text of a PRIVMSG with the /me ("\x01ACTION ...\x01") wrapper removed
+    QString getMessageText() const;
+    bool isAction() const;
+
+    const TagList &getTags() const;
+    bool hasTag(const char *key) const;
+    util::ByteView getRawTag(const char *key) const;
+
+    // Returns the unescaped value of the tag
+    QString getTag(const char *key) const;
+
+    static QString unescapeTagValue(const util::ByteView &value);
+
+private:
+    // Keeps the views below alive
+    QByteArray buffer;
+
+    util::ByteView line;
+    util::ByteView prefix;
+    util::ByteView command;
+
+    QVarLengthArray<util::ByteView, 4> parameters;
+    TagList tags;
+};
+
+}  // namespace twitch
+}  // namespace chatterino
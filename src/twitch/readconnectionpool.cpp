@@ -0,0 +1,315 @@
+#include "twitch/readconnectionpool.hpp"
+#include "twitch/twitchconnection.hpp"
+
+#include <QDebug>
+#include <QSet>
+
+#include <algorithm>
+
+namespace chatterino {
+namespace twitch {
+
+namespace {
+
+// Twitch allows 20 join attempts per 10 seconds, every channel of a batched JOIN counts
+const int joinRateLimit = 20;
+const std::chrono::milliseconds joinRatePeriod(10 * 1000);
+
+// IRC lines are limited to 512 bytes including the trailing \r\n
+const int maxJoinLineLength = 500;
+
+const int statisticsInterval = 10 * 1000;
+
+// statistics are printed every sixth update, i.e. once a minute
+const int statisticsLogInterval = 6;
+
+// channels which stay silent after a reconnect stop being tracked after this long
+const qint64 recoveryTimeout = 10 * 60 * 1000;
+
+}  // namespace
+
+ReadConnectionPool::ReadConnectionPool(const QString &host, quint16 port, const QString &nickName,
+                                       const QString &password, int connectionCount)
+    : joinRateLimiter(joinRateLimit, joinRatePeriod)
+    , joinTimer(this)
+    , statisticsTimer(this)
+{
+    connectionCount = std::max(connectionCount, 1);
+
+    for (int i = 0; i < connectionCount; i++) {
+        auto connection = new TwitchConnection(host, port, nickName, password);
+        connection->setParent(this);
+
+        connection->connected.connect([this] { this->sendPendingJoins(); });
+        connection->disconnected.connect([this, i] { this->onConnectionLost(i); });
+
+        connection->messageReceived.connect([this, i, connection](const RawIrcMessage &message) {
+            // whispers are sent to every connection we have open, only handle them once
+            if (i != 0 && message.getCommand() == "WHISPER") {
+                return;
+            }
+
+            if (!this->disconnectTimes.isEmpty() && message.getCommand() == "PRIVMSG") {
+                this->recordRecovery(message.getChannelName());
+            }
+
+            this->messageReceived(connection, message);
+        });
+
+        this->connections.push_back(connection);
+    }
+
+    this->channelCounts.resize(connectionCount, 0);
+    this->lastReceivedLines.resize(connectionCount, 0);
+    this->lastReceivedBytes.resize(connectionCount, 0);
+    this->statistics.resize(connectionCount);
+
+    this->clock.start();
+
+    this->joinTimer.setSingleShot(true);
+    QObject::connect(&this->joinTimer, &QTimer::timeout, this,
+                     &ReadConnectionPool::sendPendingJoins);
+
+    QObject::connect(&this->statisticsTimer, &QTimer::timeout, this,
+                     &ReadConnectionPool::updateStatistics);
+}
+
+std::vector<ReadConnectionStatistics> ReadConnectionPool::getStatistics() const
+{
+    std::lock_guard<std::mutex> lock(this->statisticsMutex);
+
+    return this->statistics;
+}
+
+QHash<QString, qint64> ReadConnectionPool::getRecoveryTimes() const
+{
+    std::lock_guard<std::mutex> lock(this->statisticsMutex);
+
+    return this->recoveryTimes;
+}
+
+void ReadConnectionPool::open()
+{
+    for (TwitchConnection *connection : this->connections) {
+        connection->open();
+    }
+
+    this->statisticsTimer.start(statisticsInterval);
+}
+
+void ReadConnectionPool::close()
+{
+    this->statisticsTimer.stop();
+    this->joinTimer.stop();
+
+    for (TwitchConnection *connection : this->connections) {
+        connection->close();
+    }
+}
+
+void ReadConnectionPool::joinChannel(const QString &channelName)
+{
+    if (this->channelConnections.contains(channelName)) {
+        return;
+    }
+
+    int index = this->getLeastLoadedConnection();
+
+    this->channelConnections.insert(channelName, index);
+    this->channelCounts[index]++;
+
+    this->pendingJoins.push_back({index, channelName});
+
+    this->sendPendingJoins();
+}
+
+void ReadConnectionPool::partChannel(const QString &channelName)
+{
+    auto iterator = this->channelConnections.find(channelName);
+
+    if (iterator == this->channelConnections.end()) {
+        return;
+    }
+
+    int index = iterator.value();
+
+    this->channelConnections.erase(iterator);
+    this->channelCounts[index]--;
+    this->disconnectTimes.remove(channelName);
+
+    for (auto it = this->pendingJoins.begin(); it != this->pendingJoins.end(); ++it) {
+        if (it->channelName == channelName) {
+            // we never joined it in the first place
+            this->pendingJoins.erase(it);
+            return;
+        }
+    }
+
+    this->connections[index]->sendRaw("PART #" + channelName);
+}
+
+void ReadConnectionPool::resumeReading()
+{
+    for (TwitchConnection *connection : this->connections) {
+        connection->resumeReading();
+    }
+}
+
+int ReadConnectionPool::getLeastLoadedConnection() const
+{
+    int index = 0;
+
+    for (int i = 1; i < static_cast<int>(this->channelCounts.size()); i++) {
+        if (this->channelCounts[i] < this->channelCounts[index]) {
+            index = i;
+        }
+    }
+
+    return index;
+}
+
+void ReadConnectionPool::onConnectionLost(int index)
+{
+    QSet<QString> pending;
+
+    for (const PendingJoin &join : this->pendingJoins) {
+        pending.insert(join.channelName);
+    }
+
+    qint64 now = this->clock.elapsed();
+
+    // the connection rejoins its channels in batches once it's back up
+    for (auto it = this->channelConnections.begin(); it != this->channelConnections.end(); ++it) {
+        if (it.value() != index) {
+            continue;
+        }
+
+        if (!pending.contains(it.key())) {
+            this->pendingJoins.push_back({index, it.key()});
+        }
+
+        if (!this->disconnectTimes.contains(it.key())) {
+            this->disconnectTimes.insert(it.key(), now);
+        }
+    }
+}
+
+void ReadConnectionPool::recordRecovery(const QString &channelName)
+{
+    auto iterator = this->disconnectTimes.find(channelName);
+
+    if (iterator == this->disconnectTimes.end()) {
+        return;
+    }
+
+    qint64 recoveryTime = this->clock.elapsed() - iterator.value();
+
+    this->disconnectTimes.erase(iterator);
+
+    qDebug() << "[ReadConnectionPool] First message in" << channelName << recoveryTime
+             << "ms after the connection was lost";
+
+    std::lock_guard<std::mutex> lock(this->statisticsMutex);
+
+    this->recoveryTimes.insert(channelName, recoveryTime);
+}
+
+void ReadConnectionPool::sendPendingJoins()
+{
+    std::vector<QString> lines(this->connections.size());
+    std::deque<PendingJoin> waiting;
+    bool rateLimited = false;
+
+    while (!this->pendingJoins.empty()) {
+        PendingJoin join = std::move(this->pendingJoins.front());
+        this->pendingJoins.pop_front();
+
+        // joins sent before the connection is up would be sent in a burst once it is
+        if (rateLimited || !this->connections[join.connectionIndex]->isConnected()) {
+            waiting.push_back(std::move(join));
+            continue;
+        }
+
+        if (!this->joinRateLimiter.tryAcquire()) {
+            rateLimited = true;
+            waiting.push_back(std::move(join));
+            continue;
+        }
+
+        QString &line = lines[join.connectionIndex];
+
+        if (line.length() + join.channelName.length() + 2 > maxJoinLineLength) {
+            this->connections[join.connectionIndex]->sendRaw(line);
+            line.clear();
+        }
+
+        line += line.isEmpty() ? "JOIN #" : ",#";
+        line += join.channelName;
+    }
+
+    for (size_t i = 0; i < lines.size(); i++) {
+        if (!lines[i].isEmpty()) {
+            this->connections[i]->sendRaw(lines[i]);
+        }
+    }
+
+    this->pendingJoins = std::move(waiting);
+
+    if (rateLimited && !this->joinTimer.isActive()) {
+        this->joinTimer.start(static_cast<int>(this->joinRateLimiter.getWaitTime().count()));
+    }
+}
+
+void ReadConnectionPool::updateStatistics()
+{
+    std::vector<ReadConnectionStatistics> updated(this->connections.size());
+
+    double seconds = statisticsInterval / 1000.0;
+
+    for (size_t i = 0; i < this->connections.size(); i++) {
+        TwitchConnection *connection = this->connections[i];
+        ReadConnectionStatistics &stats = updated[i];
+
+        quint64 lines = connection->getReceivedLines();
+        quint64 bytes = connection->getReceivedBytes();
+
+        stats.channelCount = this->channelCounts[i];
+        stats.connected = connection->isConnected();
+        stats.linesPerSecond = (lines - this->lastReceivedLines[i]) / seconds;
+        stats.bytesPerSecond = (bytes - this->lastReceivedBytes[i]) / seconds;
+        stats.lag = connection->getLag();
+        stats.reconnectCount = connection->getReconnectCount();
+
+        this->lastReceivedLines[i] = lines;
+        this->lastReceivedBytes[i] = bytes;
+    }
+
+    qint64 now = this->clock.elapsed();
+
+    for (auto it = this->disconnectTimes.begin(); it != this->disconnectTimes.end();) {
+        if (now - it.value() > recoveryTimeout) {
+            it = this->disconnectTimes.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    if (++this->statisticsUpdates % statisticsLogInterval == 0) {
+        for (size_t i = 0; i < updated.size(); i++) {
+            qDebug().nospace() << "[ReadConnectionPool] connection " << i << ": "
+                               << updated[i].channelCount << " channels, "
+                               << updated[i].linesPerSecond << " lines/s, "
+                               << updated[i].bytesPerSecond << " bytes/s, lag "
+                               << updated[i].lag << "ms, " << updated[i].reconnectCount
+                               << " reconnects"
+                               << (updated[i].connected ? "" : " (disconnected)");
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(this->statisticsMutex);
+
+    this->statistics = std::move(updated);
+}
+
+}  // namespace twitch
+}  // namespace chatterino
@@ -0,0 +1,106 @@
+#pragma once
+
+#include "twitch/rawircmessage.hpp"
+#include "util/ratelimiter.hpp"
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QObject>
+#include <QString>
+#include <QTimer>
+#include <boost/signals2.hpp>
+
+#include <deque>
+#include <mutex>
+#include <vector>
+
+namespace chatterino {
+namespace twitch {
+
+class TwitchConnection;
+
+struct ReadConnectionStatistics {
+    int channelCount = 0;
+    bool connected = false;
+
+    double linesPerSecond = 0.0;
+    double bytesPerSecond = 0.0;
+
+    // milliseconds between Twitch sending the last message and us parsing it
+    qint64 lag = 0;
+
+    int reconnectCount = 0;
+};
+
+// ReadConnectionPool spreads the joined channels across a number of read connections, so a
+// single socket doesn't have to carry hundreds of channels.
+// Channels are joined in batches ("JOIN #a,#b,#c") while staying under Twitch's join limit.
+// When a connection drops, its channels are rejoined the same way once it's back, and the time
+// until the first message arrives in each of those channels is recorded.
+//
+// The pool and its connections live in the IRC I/O thread. Use the slots through queued
+// invocations from other threads.
+class ReadConnectionPool : public QObject
+{
+    Q_OBJECT
+
+public:
+    ReadConnectionPool(const QString &host, quint16 port, const QString &nickName,
+                       const QString &password, int connectionCount);
+
+    // Invoked in the I/O thread for every message received on any of the connections
+    boost::signals2::signal<void(TwitchConnection *, const RawIrcMessage &)> messageReceived;
+
+    // Can be called from any thread
+    std::vector<ReadConnectionStatistics> getStatistics() const;
+
+    // channel name -> milliseconds between losing the connection and the first message after
+    // rejoining, for the last reconnect. Can be called from any thread.
+    QHash<QString, qint64> getRecoveryTimes() const;
+
+public slots:
+    void open();
+    void close();
+
+    void joinChannel(const QString &channelName);
+    void partChannel(const QString &channelName);
+
+    void resumeReading();
+
+private:
+    struct PendingJoin {
+        int connectionIndex;
+        QString channelName;
+    };
+
+    std::vector<TwitchConnection *> connections;
+
+    // channel name -> index of the connection it's joined on
+    QHash<QString, int> channelConnections;
+    std::vector<int> channelCounts;
+
+    std::deque<PendingJoin> pendingJoins;
+    util::RateLimiter joinRateLimiter;
+    QTimer joinTimer;
+
+    // channel name -> time its connection was lost, until the first message arrives again
+    QHash<QString, qint64> disconnectTimes;
+    QHash<QString, qint64> recoveryTimes;
+    QElapsedTimer clock;
+
+    QTimer statisticsTimer;
+    std::vector<quint64> lastReceivedLines;
+    std::vector<quint64> lastReceivedBytes;
+    std::vector<ReadConnectionStatistics> statistics;
+    mutable std::mutex statisticsMutex;
+    int statisticsUpdates = 0;
+
+    int getLeastLoadedConnection() const;
+    void onConnectionLost(int index);
+    void recordRecovery(const QString &channelName);
+    void sendPendingJoins();
+    void updateStatistics();
+};
+
+}  // namespace twitch
+}  // namespace chatterino
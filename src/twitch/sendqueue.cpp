@@ -0,0 +1,213 @@
+#include "twitch/sendqueue.hpp"
+#include "twitch/twitchconnection.hpp"
+
+#include <algorithm>
+
+namespace chatterino {
+namespace twitch {
+
+namespace {
+
+const std::chrono::milliseconds messageRatePeriod(30 * 1000);
+const int userMessageLimit = 20;
+const int moderatorMessageLimit = 100;
+
+const std::chrono::milliseconds channelRatePeriod(1000);
+const int channelMessageLimit = 1;
+
+// don't spin when the limits are exceeded by a tiny bit
+const int minimumWaitTime = 10;
+
+}  // namespace
+
+SendQueue::SendQueue(TwitchConnection *_connection)
+    : connection(_connection)
+    , userRateLimiter(userMessageLimit, messageRatePeriod)
+    , moderatorRateLimiter(moderatorMessageLimit, messageRatePeriod)
+    , processTimer(this)
+    , depth(0)
+    , lastWaitTime(0)
+{
+    this->connection->setParent(this);
+
+    this->processTimer.setSingleShot(true);
+    QObject::connect(&this->processTimer, &QTimer::timeout, this, &SendQueue::processQueue);
+
+    // everything queued before we were connected
+    this->connection->connected.connect([this] { this->processQueue(); });
+}
+
+int SendQueue::getDepth() const
+{
+    return this->depth;
+}
+
+qint64 SendQueue::getLastWaitTime() const
+{
+    return this->lastWaitTime;
+}
+
+void SendQueue::open()
+{
+    this->connection->open();
+}
+
+void SendQueue::close()
+{
+    this->processTimer.stop();
+
+    this->connection->close();
+}
+
+void SendQueue::sendMessage(const QString &channelName, const QString &message)
+{
+    QueuedMessage queuedMessage;
+    queuedMessage.channelName = channelName;
+    queuedMessage.text = message;
+    queuedMessage.queuedTime.start();
+    queuedMessage.sequence = this->nextSequence++;
+
+    this->channelSequences[channelName].push_back(queuedMessage.sequence);
+
+    this->queues[static_cast<int>(getPriority(message))].push_back(std::move(queuedMessage));
+    this->depth++;
+
+    this->processQueue();
+}
+
+void SendQueue::setModerator(const QString &channelName, bool isModerator)
+{
+    if (isModerator) {
+        this->moderatedChannels.insert(channelName);
+    } else {
+        this->moderatedChannels.remove(channelName);
+    }
+}
+
+SendQueue::Priority SendQueue::getPriority(const QString &message)
+{
+    if (message.startsWith('/') || message.startsWith('.')) {
+        return Priority::Command;
+    }
+
+    return Priority::Chat;
+}
+
+bool SendQueue::canSend(const QString &channelName)
+{
+    if (this->moderatorRateLimiter.getAvailable() < 1) {
+        return false;
+    }
+
+    if (this->moderatedChannels.contains(channelName)) {
+        return true;
+    }
+
+    return this->userRateLimiter.getAvailable() >= 1 &&
+           this->getChannelRateLimiter(channelName).getAvailable() >= 1;
+}
+
+void SendQueue::acquire(const QString &channelName)
+{
+    // every message counts towards the moderator limit, only messages in channels we don't
+    // moderate count towards the user and channel limits
+    this->moderatorRateLimiter.tryAcquire();
+
+    if (!this->moderatedChannels.contains(channelName)) {
+        this->userRateLimiter.tryAcquire();
+        this->getChannelRateLimiter(channelName).tryAcquire();
+    }
+}
+
+std::chrono::milliseconds SendQueue::getWaitTime(const QString &channelName)
+{
+    std::chrono::milliseconds waitTime = this->moderatorRateLimiter.getWaitTime();
+
+    if (!this->moderatedChannels.contains(channelName)) {
+        waitTime = std::max(waitTime, this->userRateLimiter.getWaitTime());
+        waitTime = std::max(waitTime, this->getChannelRateLimiter(channelName).getWaitTime());
+    }
+
+    return waitTime;
+}
+
+util::RateLimiter &SendQueue::getChannelRateLimiter(const QString &channelName)
+{
+    auto iterator = this->channelRateLimiters.find(channelName);
+
+    if (iterator == this->channelRateLimiters.end()) {
+        iterator = this->channelRateLimiters.insert(
+            channelName, util::RateLimiter(channelMessageLimit, channelRatePeriod));
+    }
+
+    return iterator.value();
+}
+
+void SendQueue::processQueue()
+{
+    if (!this->connection->isConnected()) {
+        return;
+    }
+
+    // time until the first blocked message could be sent
+    std::chrono::milliseconds waitTime = std::chrono::milliseconds::max();
+
+    // a chat message waiting behind a command of its channel can go once the command was sent
+    // in the command pass, so go again as long as something was sent
+    bool sentAny = true;
+
+    while (sentAny) {
+        sentAny = false;
+
+        // channels which hit a limit, nothing more of them is sent this time
+        QSet<QString> blockedChannels;
+
+        for (std::deque<QueuedMessage> &queue : this->queues) {
+            auto iterator = queue.begin();
+
+            while (iterator != queue.end()) {
+                const QString &channelName = iterator->channelName;
+                std::deque<quint64> &sequences = this->channelSequences[channelName];
+
+                // an older message of the channel is waiting in the other queue
+                if (blockedChannels.contains(channelName) ||
+                    sequences.front() != iterator->sequence) {
+                    ++iterator;
+                    continue;
+                }
+
+                if (!this->canSend(channelName)) {
+                    blockedChannels.insert(channelName);
+                    waitTime = std::min(waitTime, this->getWaitTime(channelName));
+                    ++iterator;
+                    continue;
+                }
+
+                this->acquire(channelName);
+
+                this->connection->sendRaw("PRIVMSG #" + channelName + " :" + iterator->text);
+
+                this->lastWaitTime = iterator->queuedTime.elapsed();
+                this->depth--;
+
+                sequences.pop_front();
+
+                if (sequences.empty()) {
+                    this->channelSequences.remove(channelName);
+                }
+
+                iterator = queue.erase(iterator);
+                sentAny = true;
+            }
+        }
+    }
+
+    if (this->depth == 0 || this->processTimer.isActive()) {
+        return;
+    }
+
+    this->processTimer.start(std::max(static_cast<int>(waitTime.count()), minimumWaitTime));
+}
+
+}  // namespace twitch
+}  // namespace chatterino
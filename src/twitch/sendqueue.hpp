@@ -0,0 +1,94 @@
+#pragma once
+
+#include "util/ratelimiter.hpp"
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QObject>
+#include <QSet>
+#include <QString>
+#include <QTimer>
+
+#include <atomic>
+#include <deque>
+
+namespace chatterino {
+namespace twitch {
+
+class TwitchConnection;
+
+// SendQueue paces everything we send on the write connection so we stay under Twitch's
+// message limits:
+//   - 20 messages per 30 seconds per account, 100 per 30 seconds in channels we moderate
+//   - 1 message per second per channel, unless we moderate the channel
+// Chat typed by the user is sent before commands (e.g. bursts of /timeout from mod tools) of
+// other channels. Messages of one channel are always sent in the order they were queued.
+//
+// The queue and its connection live in the IRC I/O thread, use the slots through queued
+// invocations. The statistics can be read from any thread.
+class SendQueue : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum class Priority {
+        Chat,
+        Command,
+    };
+
+    explicit SendQueue(TwitchConnection *_connection);
+
+    // Number of messages waiting to be sent
+    int getDepth() const;
+
+    // Milliseconds the last sent message waited in the queue
+    qint64 getLastWaitTime() const;
+
+public slots:
+    void open();
+    void close();
+
+    void sendMessage(const QString &channelName, const QString &message);
+    void setModerator(const QString &channelName, bool isModerator);
+
+private:
+    struct QueuedMessage {
+        QString channelName;
+        QString text;
+        QElapsedTimer queuedTime;
+        quint64 sequence;
+    };
+
+    TwitchConnection *connection;
+
+    // one queue per priority
+    std::deque<QueuedMessage> queues[2];
+
+    // channel name -> sequence numbers of its queued messages, oldest first. Only the oldest
+    // message of a channel may be sent, whichever queue it's in.
+    QHash<QString, std::deque<quint64>> channelSequences;
+    quint64 nextSequence = 0;
+
+    util::RateLimiter userRateLimiter;
+    util::RateLimiter moderatorRateLimiter;
+    QHash<QString, util::RateLimiter> channelRateLimiters;
+
+    QSet<QString> moderatedChannels;
+
+    QTimer processTimer;
+
+    std::atomic<int> depth;
+    std::atomic<qint64> lastWaitTime;
+
+    static Priority getPriority(const QString &message);
+
+    bool canSend(const QString &channelName);
+    void acquire(const QString &channelName);
+    std::chrono::milliseconds getWaitTime(const QString &channelName);
+    util::RateLimiter &getChannelRateLimiter(const QString &channelName);
+
+    void processQueue();
+};
+
+}  // namespace twitch
+}  // namespace chatterino
@@ -0,0 +1,341 @@
+#include "twitch/twitchconnection.hpp"
+
+#include <QDateTime>
+#include <QDebug>
+
+#include <algorithm>
+
+namespace chatterino {
+namespace twitch {
+
+namespace {
+
+// how much data is buffered in the socket while reading is paused
+const qint64 socketReadBufferSize = 1024 * 1024;
+
+// when we haven't received anything for pingInterval ms we send a PING, if nothing arrives
+// within pongTimeout ms after that the connection is dead
+const int pingInterval = 60 * 1000;
+const int pongTimeout = 10 * 1000;
+const int aliveCheckInterval = 5 * 1000;
+
+// reading is paused for at most this long at a time, well below the time Twitch waits for a PONG
+const int maximumReadPause = 30 * 1000;
+
+// reconnect delays double with every failed attempt, a random part of it is cut off so
+// hundreds of clients don't reconnect at the same time
+const int minimumReconnectDelay = 1000;
+const int maximumReconnectDelay = 60 * 1000;
+
+}  // namespace
+
+TwitchConnection::TwitchConnection(const QString &_host, quint16 _port, const QString &_nickName,
+                                   const QString &_password)
+    : host(_host)
+    , port(_port)
+    , nickName(_nickName)
+    , password(_password)
+    , random(std::random_device()())
+    , receivedLines(0)
+    , receivedBytes(0)
+    , lag(0)
+    , reconnectCount(0)
+{
+}
+
+void TwitchConnection::sendRaw(const QString &line)
+{
+    QByteArray data = line.toUtf8();
+
+    if (!this->isConnected()) {
+        this->pendingLines.append(data);
+        return;
+    }
+
+    this->write(data);
+}
+
+bool TwitchConnection::isConnected() const
+{
+    return this->socket != nullptr && this->socket->state() == QAbstractSocket::ConnectedState;
+}
+
+quint64 TwitchConnection::getReceivedLines() const
+{
+    return this->receivedLines;
+}
+
+quint64 TwitchConnection::getReceivedBytes() const
+{
+    return this->receivedBytes;
+}
+
+qint64 TwitchConnection::getLag() const
+{
+    return this->lag;
+}
+
+int TwitchConnection::getReconnectCount() const
+{
+    return this->reconnectCount;
+}
+
+void TwitchConnection::open()
+{
+    if (this->socket == nullptr) {
+        this->socket = new QTcpSocket(this);
+        this->socket->setReadBufferSize(socketReadBufferSize);
+
+        QObject::connect(this->socket, &QTcpSocket::connected, this,
+                         &TwitchConnection::onConnected);
+        QObject::connect(this->socket, &QTcpSocket::readyRead, this,
+                         &TwitchConnection::onReadyRead);
+        QObject::connect(this->socket, &QTcpSocket::disconnected, this,
+                         &TwitchConnection::onConnectionLost);
+        QObject::connect(this->socket,
+                         static_cast<void (QAbstractSocket::*)(QAbstractSocket::SocketError)>(
+                             &QAbstractSocket::error),
+                         this, [this](QAbstractSocket::SocketError) {
+                             // failed connection attempts don't emit disconnected
+                             if (this->socket->state() == QAbstractSocket::UnconnectedState) {
+                                 this->onConnectionLost();
+                             }
+                         });
+
+        this->pingTimer = new QTimer(this);
+        QObject::connect(this->pingTimer, &QTimer::timeout, this, &TwitchConnection::checkAlive);
+
+        this->reconnectTimer = new QTimer(this);
+        this->reconnectTimer->setSingleShot(true);
+        QObject::connect(this->reconnectTimer, &QTimer::timeout, this, &TwitchConnection::open);
+
+        this->pauseTimer = new QTimer(this);
+        this->pauseTimer->setSingleShot(true);
+        QObject::connect(this->pauseTimer, &QTimer::timeout, this,
+                         &TwitchConnection::resumeReading);
+    }
+
+    this->closed = false;
+
+    this->receiveBuffer.clear();
+    this->socket->connectToHost(this->host, this->port);
+}
+
+void TwitchConnection::close()
+{
+    this->closed = true;
+
+    if (this->socket != nullptr) {
+        this->pingTimer->stop();
+        this->reconnectTimer->stop();
+        this->pauseTimer->stop();
+
+        this->socket->abort();
+    }
+}
+
+void TwitchConnection::pauseReading()
+{
+    if (this->readingPaused) {
+        return;
+    }
+
+    this->readingPaused = true;
+
+    if (this->socket != nullptr) {
+        // nothing is received while paused, that's no sign of a dead connection
+        this->pingTimer->stop();
+        this->pauseTimer->start(maximumReadPause);
+    }
+}
+
+void TwitchConnection::resumeReading()
+{
+    if (!this->readingPaused) {
+        return;
+    }
+
+    this->readingPaused = false;
+
+    if (this->socket == nullptr) {
+        return;
+    }
+
+    this->pauseTimer->stop();
+
+    if (this->established) {
+        this->lastReceiveTime.start();
+        this->pingSent = false;
+        this->pingTimer->start(aliveCheckInterval);
+    }
+
+    this->processReceivedData();
+}
+
+void TwitchConnection::onConnected()
+{
+    qDebug() << "[TwitchConnection] Connected to" << this->host << this->port;
+
+    this->established = true;
+    this->lastReceiveTime.start();
+    this->pingSent = false;
+
+    if (!this->readingPaused) {
+        this->pingTimer->start(aliveCheckInterval);
+    }
+
+    if (!this->password.isEmpty()) {
+        this->write("PASS " + this->password.toUtf8());
+    }
+
+    this->write("NICK " + this->nickName.toUtf8());
+
+    this->write("CAP REQ :twitch.tv/membership");
+    this->write("CAP REQ :twitch.tv/commands");
+    this->write("CAP REQ :twitch.tv/tags");
+
+    for (const QByteArray &line : this->pendingLines) {
+        this->write(line);
+    }
+
+    this->pendingLines.clear();
+
+    this->connected();
+}
+
+void TwitchConnection::onConnectionLost()
+{
+    if (this->reconnectTimer->isActive()) {
+        // already handled
+        return;
+    }
+
+    bool wasConnected = this->established;
+
+    this->established = false;
+    this->pingTimer->stop();
+
+    // schedule before aborting, abort emits QTcpSocket::disconnected which brings us back here
+    if (!this->closed) {
+        this->scheduleReconnect();
+    }
+
+    this->socket->abort();
+
+    if (wasConnected) {
+        qDebug() << "[TwitchConnection] Lost connection to" << this->host << this->port;
+
+        this->disconnected();
+    }
+}
+
+void TwitchConnection::checkAlive()
+{
+    qint64 silence = this->lastReceiveTime.elapsed();
+
+    if (this->pingSent && silence > pingInterval + pongTimeout) {
+        qDebug() << "[TwitchConnection] No PONG received for" << silence << "ms";
+
+        this->onConnectionLost();
+    } else if (!this->pingSent && silence > pingInterval) {
+        this->write("PING :tmi.twitch.tv");
+        this->pingSent = true;
+    }
+}
+
+void TwitchConnection::scheduleReconnect()
+{
+    int delay = minimumReconnectDelay;
+
+    for (int i = 0; i < this->failedAttempts && delay < maximumReconnectDelay; i++) {
+        delay *= 2;
+    }
+
+    delay = std::min(delay, maximumReconnectDelay);
+
+    std::uniform_int_distribution<int> jitter(delay / 2, delay);
+    delay = jitter(this->random);
+
+    this->failedAttempts++;
+    this->reconnectCount++;
+
+    qDebug() << "[TwitchConnection] Reconnecting in" << delay << "ms";
+
+    this->reconnectTimer->start(delay);
+}
+
+void TwitchConnection::onReadyRead()
+{
+    if (this->readingPaused) {
+        return;
+    }
+
+    this->processReceivedData();
+}
+
+void TwitchConnection::processReceivedData()
+{
+    // Lines are parsed in place, every RawIrcMessage shares the chunk it was read from
+    QByteArray chunk = this->socket->readAll();
+
+    this->receivedBytes += chunk.size();
+
+    if (!chunk.isEmpty()) {
+        this->lastReceiveTime.start();
+        this->pingSent = false;
+        this->failedAttempts = 0;
+    }
+
+    if (!this->receiveBuffer.isEmpty()) {
+        chunk.prepend(this->receiveBuffer);
+        this->receiveBuffer.clear();
+    }
+
+    RawIrcMessage message;
+    int lineStart = 0;
+    int lineBreak;
+
+    // messageReceived may pause reading, the rest of the chunk is kept for resumeReading
+    while (!this->readingPaused && (lineBreak = chunk.indexOf('\n', lineStart)) != -1) {
+        int lineEnd = lineBreak;
+
+        if (lineEnd > lineStart && chunk.at(lineEnd - 1) == '\r') {
+            lineEnd--;
+        }
+
+        if (lineEnd > lineStart &&
+            RawIrcMessage::parse(chunk, lineStart, lineEnd - lineStart, message)) {
+            this->receivedLines++;
+
+            if (message.getCommand() == "PING") {
+                this->write("PONG :" + message.getContent().toByteArray());
+            } else if (message.getCommand() == "PONG") {
+                // answer to our keepalive, nothing else to do
+            } else {
+                if (message.getCommand() == "PRIVMSG") {
+                    qint64 sentTime = message.getRawTag("tmi-sent-ts").toLongLong(-1);
+
+                    if (sentTime != -1) {
+                        this->lag = QDateTime::currentMSecsSinceEpoch() - sentTime;
+                    }
+                }
+
+                this->messageReceived(message);
+            }
+        }
+
+        lineStart = lineBreak + 1;
+    }
+
+    if (lineStart < chunk.size()) {
+        this->receiveBuffer = chunk.mid(lineStart);
+    }
+}
+
+void TwitchConnection::write(const QByteArray &line)
+{
+    this->socket->write(line + "\r\n");
+}
+
+}  // namespace twitch
+}  // namespace chatterino
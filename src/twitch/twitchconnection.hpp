@@ -0,0 +1,110 @@
+#pragma once
+
+#include "twitch/rawircmessage.hpp"
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QList>
+#include <QObject>
+#include <QString>
+#include <QTcpSocket>
+#include <QTimer>
+#include <boost/signals2.hpp>
+
+#include <atomic>
+#include <random>
+
+namespace chatterino {
+namespace twitch {
+
+// TwitchConnection is a bare bones connection to the Twitch IRC server. Unlike
+// Communi::IrcConnection it doesn't create an IrcMessage object per received line, instead every
+// line is parsed into a RawIrcMessage which points into the receive buffer.
+//
+// Once opened, the connection supervises itself: if nothing is received for a while it sends a
+// PING, if that isn't answered the socket is considered dead. Whenever the connection is lost it
+// reconnects with a jittered exponential backoff, until close is called.
+class TwitchConnection : public QObject
+{
+    Q_OBJECT
+
+public:
+    TwitchConnection(const QString &_host, quint16 _port, const QString &_nickName,
+                     const QString &_password);
+
+    // Queues the line to be sent once we are connected. Must be called from the thread the
+    // connection lives in. messageReceived is invoked in that thread as well.
+    void sendRaw(const QString &line);
+
+    bool isConnected() const;
+
+    // Statistics, these can be read from any thread
+    quint64 getReceivedLines() const;
+    quint64 getReceivedBytes() const;
+
+    // Delay between Twitch sending the last PRIVMSG (tmi-sent-ts) and us parsing it
+    qint64 getLag() const;
+
+    int getReconnectCount() const;
+
+    boost::signals2::signal<void()> connected;
+    boost::signals2::signal<void()> disconnected;
+    boost::signals2::signal<void(const RawIrcMessage &)> messageReceived;
+
+public slots:
+    void open();
+    void close();
+
+    // While reading is paused, received data is left in the socket. The socket's read buffer is
+    // limited, so the server eventually has to stop sending. The silence doesn't count towards the
+    // keepalive, and reading resumes on its own after a while so PINGs in the buffer get answered.
+    void pauseReading();
+    void resumeReading();
+
+private:
+    QString host;
+    quint16 port;
+    QString nickName;
+    QString password;
+
+    QTcpSocket *socket = nullptr;
+
+    // set by close, we don't reconnect after that
+    bool closed = true;
+
+    QTimer *pingTimer = nullptr;
+    QTimer *reconnectTimer = nullptr;
+    QTimer *pauseTimer = nullptr;
+    QElapsedTimer lastReceiveTime;
+    bool pingSent = false;
+
+    // number of reconnects since we last received something
+    int failedAttempts = 0;
+    std::mt19937 random;
+
+    // bytes of a line which hasn't been fully received yet
+    QByteArray receiveBuffer;
+
+    QList<QByteArray> pendingLines;
+
+    bool readingPaused = false;
+
+    // between onConnected and onConnectionLost
+    bool established = false;
+
+    std::atomic<quint64> receivedLines;
+    std::atomic<quint64> receivedBytes;
+    std::atomic<qint64> lag;
+    std::atomic<int> reconnectCount;
+
+    void onConnected();
+    void onConnectionLost();
+    void onReadyRead();
+    void checkAlive();
+    void scheduleReconnect();
+    void processReceivedData();
+    void write(const QByteArray &line);
+};
+
+}  // namespace twitch
+}  // namespace chatterino
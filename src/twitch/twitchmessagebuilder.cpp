@@ -3,6 +3,7 @@
 #include "emotemanager.hpp"
 #include "ircmanager.hpp"
 #include "resources.hpp"
+#include "settingsmanager.hpp"
 #include "windowmanager.hpp"
 
 using namespace chatterino::messages;
@@ -13,16 +14,17 @@ namespace twitch {
 TwitchMessageBuilder::TwitchMessageBuilder(Channel *_channel, Resources &_resources,
                                            EmoteManager &_emoteManager,
                                            WindowManager &_windowManager,
-                                           const Communi::IrcPrivateMessage *_ircMessage,
+                                           const HighlightEngine &_highlightEngine,
+                                           const RawIrcMessage &_ircMessage,
                                            const messages::MessageParseArgs &_args)
     : channel(_channel)
     , resources(_resources)
     , windowManager(_windowManager)
     , colorScheme(this->windowManager.colorScheme)
     , emoteManager(_emoteManager)
+    , highlightEngine(_highlightEngine)
     , ircMessage(_ircMessage)
     , args(_args)
-    , tags(this->ircMessage->tags())
     , usernameColor(this->colorScheme.SystemMessageColor)
 {
 }
@@ -33,40 +35,79 @@ SharedMessage TwitchMessageBuilder::parse()
     // Whether or not will be rendered is decided/checked later
     this->appendTimestamp();
 
+    this->parseMetadata();
+
+    // highlights
+    this->parseHighlights(this->originalMessage);
+
+    this->appendWords();
+
+    return this->build();
+}
+
+SharedMessage TwitchMessageBuilder::parseWithoutWords()
+{
+    this->parseMetadata();
+
+    // highlights
+    this->parseHighlights(this->originalMessage);
+
+    return this->build();
+}
+
+std::vector<Word> TwitchMessageBuilder::parseWords(std::time_t time)
+{
+    this->appendTimestamp(time);
+
+    // the words link to the message id and the badges depend on the room id
+    this->parseMetadata();
+
+    this->appendWords();
+
+    return this->takeWords();
+}
+
+void TwitchMessageBuilder::parseMetadata()
+{
     this->parseMessageID();
 
     this->parseRoomID();
 
+    this->setChannelName(this->channel->name);
+
+    this->parseBadgeNames();
+
+    this->parseUserName();
+
+    this->setBits(this->ircMessage.getTag("bits").toInt());
+
+    this->originalMessage = this->ircMessage.getMessageText();
+}
+
+void TwitchMessageBuilder::appendWords()
+{
     this->appendModerationButtons();
 
     this->parseTwitchBadges();
 
-    if (this->args.includeChannelName) {
-        this->parseChannelName();
-    }
-
-    this->parseUsername();
+    this->parseChannelName();
 
-    // highlights
-    // TODO: implement this xD
+    this->appendUsername();
 
     // bits
-    QString bits = "";
+    QString bits = this->ircMessage.getTag("bits");
 
-    auto iterator = this->tags.find("bits");
-    if (iterator != this->tags.end()) {
-        bits = iterator.value().toString();
-    }
+    const QString originalMessage = this->originalMessage;
 
     // twitch emotes
     std::vector<std::pair<long, EmoteData>> twitchEmotes;
 
-    iterator = this->tags.find("emotes");
-    if (iterator != this->tags.end()) {
-        QStringList emoteString = iterator.value().toString().split('/');
+    QString emotes = this->ircMessage.getTag("emotes");
+    if (!emotes.isEmpty()) {
+        QStringList emoteString = emotes.split('/');
 
         for (QString emote : emoteString) {
-            this->appendTwitchEmote(ircMessage, emote, twitchEmotes, emoteManager);
+            this->appendTwitchEmote(originalMessage, emote, twitchEmotes, emoteManager);
         }
 
         struct {
@@ -83,10 +124,8 @@ SharedMessage TwitchMessageBuilder::parse()
     auto currentTwitchEmote = twitchEmotes.begin();
 
     // words
-    QColor textColor = ircMessage->isAction() ? this->usernameColor : this->colorScheme.Text;
+    QColor textColor = this->ircMessage.isAction() ? this->usernameColor : this->colorScheme.Text;
 
-    const QString &originalMessage = ircMessage->content();
-    this->originalMessage = originalMessage;
     QStringList splits = originalMessage.split(' ');
 
     long int i = 0;
@@ -218,24 +257,18 @@ SharedMessage TwitchMessageBuilder::parse()
     //    {
     //        HighlightTab = false;
     //    }
-
-    return this->build();
 }
 
 void TwitchMessageBuilder::parseMessageID()
 {
-    auto iterator = this->tags.find("id");
-
-    if (iterator != this->tags.end()) {
-        this->messageID = iterator.value().toString();
-    }
+    this->messageID = this->ircMessage.getTag("id");
 }
 
 void TwitchMessageBuilder::parseRoomID()
 {
-    auto iterator = this->tags.find("room-id");
-    if (iterator != std::end(this->tags)) {
-        this->roomID = iterator.value().toString().toStdString();
+    util::ByteView roomID = this->ircMessage.getRawTag("room-id");
+    if (!roomID.isEmpty()) {
+        this->roomID = roomID.toByteArray().toStdString();
 
         if (this->channel->roomID.empty()) {
             this->channel->roomID = this->roomID;
@@ -246,31 +279,37 @@ void TwitchMessageBuilder::parseRoomID()
 void TwitchMessageBuilder::parseChannelName()
 {
     QString channelName("#" + this->channel->name);
-    this->appendWord(Word(channelName, Word::Misc, this->colorScheme.SystemMessageColor,
+    // hidden unless the split merges several channels or the channel name was asked for
+    Word::Type type = this->args.includeChannelName ? Word::Misc : Word::ChannelName;
+
+    this->appendWord(Word(channelName, type, this->colorScheme.SystemMessageColor,
                           QString(channelName), QString(),
                           Link(Link::Url, this->channel->name + "\n" + this->messageID)));
 }
 
-void TwitchMessageBuilder::parseUsername()
+void TwitchMessageBuilder::parseUserName()
 {
-    auto iterator = this->tags.find("color");
-    if (iterator != this->tags.end()) {
-        this->usernameColor = QColor(iterator.value().toString());
+    this->userName = this->ircMessage.getNick().toString();
+
+    if (this->userName.isEmpty()) {
+        this->userName = this->ircMessage.getTag("login");
     }
 
-    // username
-    this->userName = ircMessage->nick();
+    this->setUserName(this->userName);
+}
 
-    if (this->userName.isEmpty()) {
-        this->userName = this->tags.value(QLatin1String("login")).toString();
+void TwitchMessageBuilder::appendUsername()
+{
+    util::ByteView color = this->ircMessage.getRawTag("color");
+    if (!color.isEmpty()) {
+        this->usernameColor = QColor(color.toString());
     }
 
     QString username = this->userName;
     QString localizedName;
 
-    iterator = this->tags.find("display-name");
-    if (iterator != this->tags.end()) {
-        QString displayName = iterator.value().toString();
+    QString displayName = this->ircMessage.getTag("display-name");
+    if (!displayName.isEmpty()) {
 
         if (QString::compare(displayName, this->userName, Qt::CaseInsensitive) == 0) {
             username = displayName;
@@ -316,11 +355,11 @@ void TwitchMessageBuilder::parseUsername()
     }
 
     if (this->args.isReceivedWhisper) {
-        // TODO(pajlada): Re-implement
-        // userDisplayString += " -> " + IrcManager::getInstance().getUser().getUserName();
+        // WHISPER <recipient> :<message>
+        usernameString += " -> " + this->ircMessage.getTarget().toString();
     }
 
-    if (!ircMessage->isAction()) {
+    if (!this->ircMessage.isAction()) {
         usernameString += ": ";
     }
 
@@ -328,20 +367,33 @@ void TwitchMessageBuilder::parseUsername()
                           QString(), Link(Link::UserInfo, this->userName)));
 }
 
+void TwitchMessageBuilder::parseHighlights(const QString &originalMessage)
+{
+    if (!SettingsManager::getInstance().enableHighlights.get()) {
+        return;
+    }
+
+    if (this->highlightEngine.isHighlighted(this->userName, this->ircMessage.getContent(),
+                                            originalMessage)) {
+        this->setHighlight(true);
+    }
+}
+
 void TwitchMessageBuilder::appendModerationButtons()
 {
     // mod buttons
     static QString buttonBanTooltip("Ban user");
     static QString buttonTimeoutTooltip("Timeout user");
 
+    QString account = this->ircMessage.getNick().toString();
+
     this->appendWord(Word(this->resources.buttonBan, Word::ButtonBan, QString(), buttonBanTooltip,
-                          Link(Link::UserBan, ircMessage->account())));
+                          Link(Link::UserBan, account)));
     this->appendWord(Word(this->resources.buttonTimeout, Word::ButtonTimeout, QString(),
-                          buttonTimeoutTooltip, Link(Link::UserTimeout, ircMessage->account())));
+                          buttonTimeoutTooltip, Link(Link::UserTimeout, account)));
 }
 
-void TwitchMessageBuilder::appendTwitchEmote(const Communi::IrcPrivateMessage *ircMessage,
-                                             const QString &emote,
+void TwitchMessageBuilder::appendTwitchEmote(const QString &content, const QString &emote,
                                              std::vector<std::pair<long int, EmoteData>> &vec,
                                              EmoteManager &emoteManager)
 {
@@ -369,11 +421,11 @@ void TwitchMessageBuilder::appendTwitchEmote(const Communi::IrcPrivateMessage *i
         long int start = std::stol(coords.at(0).toStdString(), nullptr, 10);
         long int end = std::stol(coords.at(1).toStdString(), nullptr, 10);
 
-        if (start >= end || start < 0 || end > ircMessage->content().length()) {
+        if (start >= end || start < 0 || end > content.length()) {
             return;
         }
 
-        QString name = ircMessage->content().mid(start, end - start + 1);
+        QString name = content.mid(start, end - start + 1);
 
         vec.push_back(
             std::pair<long int, EmoteData>(start, emoteManager.getTwitchEmoteById(id, name)));
@@ -414,18 +466,32 @@ bool TwitchMessageBuilder::appendEmote(EmoteData &emoteData)
     return true;
 }
 
+void TwitchMessageBuilder::parseBadgeNames()
+{
+    // "moderator/1" -> "moderator", for message filters
+    QStringList badgeNames;
+
+    for (const QString &badge : this->ircMessage.getTag("badges").split(',')) {
+        if (!badge.isEmpty()) {
+            badgeNames.append(badge.section('/', 0, 0));
+        }
+    }
+
+    this->setBadges(badgeNames);
+}
+
 void TwitchMessageBuilder::parseTwitchBadges()
 {
     const auto &channelResources = this->resources.channels[this->roomID];
 
-    auto iterator = this->tags.find("badges");
+    QString badgesTag = this->ircMessage.getTag("badges");
 
-    if (iterator == this->tags.end()) {
+    if (badgesTag.isEmpty()) {
         // No badges in this message
         return;
     }
 
-    QStringList badges = iterator.value().toString().split(',');
+    QStringList badges = badgesTag.split(',');
 
     for (QString badge : badges) {
         if (badge.isEmpty()) {
@@ -1,8 +1,10 @@
 #pragma once
 
 #include "emotemanager.hpp"
+#include "messages/highlightengine.hpp"
 #include "messages/messagebuilder.hpp"
 #include "resources.hpp"
+#include "twitch/rawircmessage.hpp"
 
 #include <QString>
 #include <QVariant>
@@ -28,7 +30,8 @@ public:
 
     explicit TwitchMessageBuilder(Channel *_channel, Resources &_resources,
                                   EmoteManager &_emoteManager, WindowManager &_windowManager,
-                                  const Communi::IrcPrivateMessage *_ircMessage,
+                                  const messages::HighlightEngine &_highlightEngine,
+                                  const RawIrcMessage &_ircMessage,
                                   const messages::MessageParseArgs &_args);
 
     Channel *channel;
@@ -36,15 +39,20 @@ public:
     WindowManager &windowManager;
     ColorScheme &colorScheme;
     EmoteManager &emoteManager;
-    const Communi::IrcPrivateMessage *ircMessage;
+    const messages::HighlightEngine &highlightEngine;
+    const RawIrcMessage &ircMessage;
     messages::MessageParseArgs args;
-    const QVariantMap tags;
 
     QString messageID;
     QString userName;
 
     messages::SharedMessage parse();
 
+    // Only parses what's needed to route, highlight, filter and search the message, the words
+    // can be added later with parseWords, see Message::setWordBuilder
+    messages::SharedMessage parseWithoutWords();
+    std::vector<messages::Word> parseWords(std::time_t time);
+
     //    static bool sortTwitchEmotes(
     //        const std::pair<long int, messages::LazyLoadedImage *> &a,
     //        const std::pair<long int, messages::LazyLoadedImage *> &b);
@@ -57,10 +65,15 @@ private:
     void parseMessageID();
     void parseRoomID();
     void parseChannelName();
-    void parseUsername();
+    void parseMetadata();
+    void parseBadgeNames();
+    void parseUserName();
+    void parseHighlights(const QString &originalMessage);
 
+    void appendWords();
+    void appendUsername();
     void appendModerationButtons();
-    void appendTwitchEmote(const Communi::IrcPrivateMessage *ircMessage, const QString &emote,
+    void appendTwitchEmote(const QString &content, const QString &emote,
                            std::vector<std::pair<long, EmoteData>> &vec,
                            EmoteManager &emoteManager);
     bool tryAppendEmote(QString &emoteString);
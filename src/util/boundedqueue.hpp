@@ -0,0 +1,70 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace chatterino {
+namespace util {
+
+// BoundedQueue is a thread safe FIFO queue used to hand items from one thread to another.
+// The capacity isn't enforced by the queue itself: push reports when the queue is full, and
+// the producer is expected to stop producing until the consumer drained it.
+template <typename T>
+class BoundedQueue
+{
+public:
+    explicit BoundedQueue(size_t _capacity)
+        : capacity(_capacity)
+    {
+    }
+
+    // Appends the item. Returns false if the queue reached its capacity.
+    bool push(T item)
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+
+        this->items.push_back(std::move(item));
+
+        return this->items.size() < this->capacity;
+    }
+
+    // Moves up to maxCount items into out. Returns the number of items still left in the queue.
+    size_t popBatch(std::vector<T> &out, size_t maxCount)
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+
+        size_t count = std::min(maxCount, this->items.size());
+
+        for (size_t i = 0; i < count; i++) {
+            out.push_back(std::move(this->items.front()));
+            this->items.pop_front();
+        }
+
+        return this->items.size();
+    }
+
+    size_t size() const
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+
+        return this->items.size();
+    }
+
+    size_t getCapacity() const
+    {
+        return this->capacity;
+    }
+
+private:
+    const size_t capacity;
+
+    mutable std::mutex mutex;
+    std::deque<T> items;
+};
+
+}  // namespace util
+}  // namespace chatterino
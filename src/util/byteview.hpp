@@ -0,0 +1,153 @@
+#pragma once
+
+#include <QByteArray>
+#include <QString>
+
+#include <cstring>
+
+namespace chatterino {
+namespace util {
+
+// ByteView is a non-owning view into a UTF-8 byte buffer (usually the receive buffer of a
+// connection). Whoever hands out a ByteView is responsible for keeping the buffer alive.
+class ByteView
+{
+public:
+    ByteView() = default;
+
+    ByteView(const char *_data, int _size)
+        : data(_data)
+        , size(_size)
+    {
+    }
+
+    const char *getData() const
+    {
+        return this->data;
+    }
+
+    int getSize() const
+    {
+        return this->size;
+    }
+
+    bool isEmpty() const
+    {
+        return this->size == 0;
+    }
+
+    char at(int index) const
+    {
+        return this->data[index];
+    }
+
+    bool startsWith(char c) const
+    {
+        return this->size > 0 && this->data[0] == c;
+    }
+
+    bool endsWith(char c) const
+    {
+        return this->size > 0 && this->data[this->size - 1] == c;
+    }
+
+    bool startsWith(const char *str) const
+    {
+        int length = static_cast<int>(std::strlen(str));
+
+        return length <= this->size && std::memcmp(this->data, str, length) == 0;
+    }
+
+    int indexOf(char c, int from = 0) const
+    {
+        for (int i = from; i < this->size; i++) {
+            if (this->data[i] == c) {
+                return i;
+            }
+        }
+
+        return -1;
+    }
+
+    ByteView mid(int position, int length = -1) const
+    {
+        if (position >= this->size) {
+            return ByteView();
+        }
+
+        if (length < 0 || position + length > this->size) {
+            length = this->size - position;
+        }
+
+        return ByteView(this->data + position, length);
+    }
+
+    ByteView left(int length) const
+    {
+        return this->mid(0, length);
+    }
+
+    bool operator==(const ByteView &other) const
+    {
+        return this->size == other.size && std::memcmp(this->data, other.data, this->size) == 0;
+    }
+
+    bool operator!=(const ByteView &other) const
+    {
+        return !(*this == other);
+    }
+
+    bool operator==(const char *str) const
+    {
+        if (this->size == 0) {
+            return str[0] == '\0';
+        }
+
+        return std::strncmp(this->data, str, this->size) == 0 && str[this->size] == '\0';
+    }
+
+    bool operator!=(const char *str) const
+    {
+        return !(*this == str);
+    }
+
+    // Parses a decimal integer, returns defaultValue if the view isn't one
+    long long toLongLong(long long defaultValue = 0) const
+    {
+        if (this->size == 0) {
+            return defaultValue;
+        }
+
+        bool negative = this->data[0] == '-';
+        long long value = 0;
+
+        for (int i = negative ? 1 : 0; i < this->size; i++) {
+            char c = this->data[i];
+
+            if (c < '0' || c > '9') {
+                return defaultValue;
+            }
+
+            value = value * 10 + (c - '0');
+        }
+
+        return negative ? -value : value;
+    }
+
+    QString toString() const
+    {
+        return QString::fromUtf8(this->data, this->size);
+    }
+
+    QByteArray toByteArray() const
+    {
+        return QByteArray(this->data, this->size);
+    }
+
+private:
+    const char *data = nullptr;
+    int size = 0;
+};
+
+}  // namespace util
+}  // namespace chatterino
@@ -0,0 +1,159 @@
+#include "util/multipatternmatcher.hpp"
+
+#include <queue>
+
+namespace chatterino {
+namespace util {
+
+MultiPatternMatcher::MultiPatternMatcher(const std::vector<Pattern> &_patterns)
+    : patterns(_patterns)
+{
+    // trie of all patterns
+    this->nodes.emplace_back();
+
+    for (int i = 0; i < static_cast<int>(this->patterns.size()); i++) {
+        const QByteArray &text = this->patterns[i].text;
+
+        if (text.isEmpty()) {
+            continue;
+        }
+
+        int node = 0;
+
+        for (char c : text) {
+            unsigned char byte = fold(c);
+            int next = this->getTransition(node, byte);
+
+            if (next == -1) {
+                next = static_cast<int>(this->nodes.size());
+                this->nodes[node].transitions.push_back({byte, next});
+                this->nodes.emplace_back();
+            }
+
+            node = next;
+        }
+
+        this->nodes[node].outputs.push_back(i);
+    }
+
+    // fail links, breadth first so the links of shorter prefixes are known
+    std::queue<int> queue;
+
+    for (const Transition &transition : this->nodes[0].transitions) {
+        queue.push(transition.node);
+    }
+
+    while (!queue.empty()) {
+        int node = queue.front();
+        queue.pop();
+
+        for (const Transition &transition : this->nodes[node].transitions) {
+            int fail = this->nodes[node].fail;
+
+            while (fail != 0 && this->getTransition(fail, transition.byte) == -1) {
+                fail = this->nodes[fail].fail;
+            }
+
+            int failTarget = this->getTransition(fail, transition.byte);
+
+            Node &child = this->nodes[transition.node];
+            child.fail = failTarget == -1 || failTarget == transition.node ? 0 : failTarget;
+            child.outputLink = this->nodes[child.fail].outputs.empty()
+                                   ? this->nodes[child.fail].outputLink
+                                   : child.fail;
+
+            queue.push(transition.node);
+        }
+    }
+}
+
+bool MultiPatternMatcher::isEmpty() const
+{
+    return this->nodes.size() <= 1;
+}
+
+int MultiPatternMatcher::findFirst(const char *data, int size) const
+{
+    if (this->isEmpty()) {
+        return -1;
+    }
+
+    int node = 0;
+
+    for (int i = 0; i < size; i++) {
+        unsigned char byte = fold(data[i]);
+        int next;
+
+        while ((next = this->getTransition(node, byte)) == -1 && node != 0) {
+            node = this->nodes[node].fail;
+        }
+
+        node = next == -1 ? 0 : next;
+
+        // every pattern ending at i is either in this node or on its output chain
+        for (int output = this->nodes[node].outputs.empty() ? this->nodes[node].outputLink : node;
+             output != -1; output = this->nodes[output].outputLink) {
+            for (int pattern : this->nodes[output].outputs) {
+                if (this->isMatch(pattern, data, size, i)) {
+                    return pattern;
+                }
+            }
+        }
+    }
+
+    return -1;
+}
+
+int MultiPatternMatcher::getTransition(int node, unsigned char byte) const
+{
+    for (const Transition &transition : this->nodes[node].transitions) {
+        if (transition.byte == byte) {
+            return transition.node;
+        }
+    }
+
+    return -1;
+}
+
+bool MultiPatternMatcher::isMatch(int pattern, const char *data, int size, int end) const
+{
+    int start = end - this->patterns[pattern].text.size() + 1;
+
+    switch (this->patterns[pattern].boundary) {
+        case Boundary::Space:
+            return (start == 0 || isSpace(data[start - 1])) &&
+                   (end + 1 == size || isSpace(data[end + 1]));
+
+        case Boundary::Word:
+            return (start == 0 || !isWordCharacter(data[start - 1])) &&
+                   (end + 1 == size || !isWordCharacter(data[end + 1]));
+
+        default:
+            return true;
+    }
+}
+
+unsigned char MultiPatternMatcher::fold(char c)
+{
+    if (c >= 'A' && c <= 'Z') {
+        return static_cast<unsigned char>(c - 'A' + 'a');
+    }
+
+    return static_cast<unsigned char>(c);
+}
+
+bool MultiPatternMatcher::isSpace(char c)
+{
+    // /me messages are wrapped in \x01ACTION ...\x01, the last word ends at the \x01
+    return c == ' ' || c == '\x01';
+}
+
+bool MultiPatternMatcher::isWordCharacter(char c)
+{
+    // bytes of multi-byte UTF-8 characters count as letters
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') ||
+           c == '_' || static_cast<unsigned char>(c) >= 0x80;
+}
+
+}  // namespace util
+}  // namespace chatterino
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <QByteArray>
+
+#include <vector>
+
+namespace chatterino {
+namespace util {
+
+// MultiPatternMatcher finds any of a set of patterns in a UTF-8 text in a single pass
+// (Aho-Corasick), no matter how many patterns there are.
+// Matching is case insensitive for ASCII letters only.
+class MultiPatternMatcher
+{
+public:
+    enum class Boundary {
+        // match anywhere in the text
+        None,
+        // only match if surrounded by spaces or the start/end of the text, e.g. emotes. The \x01
+        // around CTCP messages like /me counts as a space.
+        Space,
+        // only match if not surrounded by letters, digits or underscores, e.g. user names
+        Word,
+    };
+
+    struct Pattern {
+        QByteArray text;
+        Boundary boundary = Boundary::None;
+    };
+
+    MultiPatternMatcher() = default;
+    explicit MultiPatternMatcher(const std::vector<Pattern> &patterns);
+
+    bool isEmpty() const;
+
+    // Returns the index of the first pattern found in the text, -1 if there is none
+    int findFirst(const char *data, int size) const;
+
+private:
+    struct Transition {
+        unsigned char byte;
+        int node;
+    };
+
+    struct Node {
+        std::vector<Transition> transitions;
+        int fail = 0;
+
+        // next node on the fail chain which has outputs
+        int outputLink = -1;
+
+        // patterns ending in this node
+        std::vector<int> outputs;
+    };
+
+    std::vector<Pattern> patterns;
+    std::vector<Node> nodes;
+
+    int getTransition(int node, unsigned char byte) const;
+    bool isMatch(int pattern, const char *data, int size, int end) const;
+
+    static unsigned char fold(char c);
+    static bool isSpace(char c);
+    static bool isWordCharacter(char c);
+};
+
+}  // namespace util
+}  // namespace chatterino
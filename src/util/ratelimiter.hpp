@@ -0,0 +1,92 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+
+namespace chatterino {
+namespace util {
+
+// RateLimiter is a token bucket: up to capacity actions are allowed in a burst, and tokens are
+// refilled continuously so that at most capacity actions happen per period.
+// It's not thread safe, use it from a single thread.
+class RateLimiter
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    RateLimiter(int _capacity, std::chrono::milliseconds _period)
+        : capacity(_capacity)
+        , period(_period)
+        , tokens(_capacity)
+        , lastRefill(Clock::now())
+    {
+    }
+
+    // Takes one token if one is available
+    bool tryAcquire()
+    {
+        this->refill();
+
+        if (this->tokens < 1.0) {
+            return false;
+        }
+
+        this->tokens -= 1.0;
+
+        return true;
+    }
+
+    int getAvailable()
+    {
+        this->refill();
+
+        return static_cast<int>(this->tokens);
+    }
+
+    // Time until the next token is available, zero if one is available right now
+    std::chrono::milliseconds getWaitTime()
+    {
+        this->refill();
+
+        if (this->tokens >= 1.0) {
+            return std::chrono::milliseconds(0);
+        }
+
+        double missing = 1.0 - this->tokens;
+
+        return std::chrono::milliseconds(
+            static_cast<long long>(missing * this->period.count() / this->capacity) + 1);
+    }
+
+    // Changes the limit, e.g. when we become a moderator. The current tokens are kept.
+    void setLimit(int _capacity, std::chrono::milliseconds _period)
+    {
+        this->refill();
+
+        this->capacity = _capacity;
+        this->period = _period;
+        this->tokens = std::min<double>(this->tokens, _capacity);
+    }
+
+private:
+    int capacity;
+    std::chrono::milliseconds period;
+
+    double tokens;
+    Clock::time_point lastRefill;
+
+    void refill()
+    {
+        auto now = Clock::now();
+        std::chrono::duration<double, std::milli> elapsed = now - this->lastRefill;
+
+        this->lastRefill = now;
+
+        double refilled = elapsed.count() * this->capacity / this->period.count();
+
+        this->tokens = std::min<double>(this->capacity, this->tokens + refilled);
+    }
+};
+
+}  // namespace util
+}  // namespace chatterino
@@ -0,0 +1,138 @@
+#pragma once
+
+#include <QTimer>
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace chatterino {
+namespace util {
+
+// RcuPointer publishes an immutable object to readers on any thread without locking.
+//
+// Readers announce themselves in one of two counters, picked by the current epoch, and load the
+// pointer after that. The writer swaps the pointer and retires the old object. A retired object is
+// deleted once both counters were seen at zero after it was retired. A reader holding it counts
+// towards its counter the whole time, so it must be done by then. The epoch is flipped on every
+// check, so new readers move to the other counter and the one being waited on drains.
+//
+// publish() and the destructor must be called from the GUI thread, which deletes retired objects.
+template <typename T>
+class RcuPointer
+{
+public:
+    // Keeps the object it was created with alive until it's destroyed, keep it short lived
+    class ReadGuard
+    {
+    public:
+        explicit ReadGuard(const RcuPointer &_pointer)
+            : pointer(_pointer)
+            , slot(_pointer.epoch.load() & 1)
+        {
+            this->pointer.readers[this->slot]++;
+            this->object = this->pointer.current.load();
+        }
+
+        ~ReadGuard()
+        {
+            this->pointer.readers[this->slot]--;
+        }
+
+        ReadGuard(const ReadGuard &) = delete;
+        ReadGuard &operator=(const ReadGuard &) = delete;
+
+        const T *operator->() const
+        {
+            return this->object;
+        }
+
+        const T &operator*() const
+        {
+            return *this->object;
+        }
+
+    private:
+        const RcuPointer &pointer;
+        int slot;
+        const T *object;
+    };
+
+    explicit RcuPointer(std::unique_ptr<const T> initial)
+        : current(initial.release())
+        , epoch(0)
+    {
+        this->readers[0] = 0;
+        this->readers[1] = 0;
+
+        this->reclaimTimer.setInterval(reclaimInterval);
+
+        QObject::connect(&this->reclaimTimer, &QTimer::timeout, [this] { this->reclaim(); });
+    }
+
+    ~RcuPointer()
+    {
+        delete this->current.load();
+    }
+
+    RcuPointer(const RcuPointer &) = delete;
+    RcuPointer &operator=(const RcuPointer &) = delete;
+
+    void publish(std::unique_ptr<const T> object)
+    {
+        Retired retired;
+        retired.object.reset(this->current.exchange(object.release()));
+        retired.drainedSlots = 0;
+
+        this->retired.push_back(std::move(retired));
+
+        this->reclaim();
+
+        if (!this->retired.empty() && !this->reclaimTimer.isActive()) {
+            this->reclaimTimer.start();
+        }
+    }
+
+private:
+    static const int reclaimInterval = 50;
+
+    struct Retired {
+        std::unique_ptr<const T> object;
+
+        // bit per reader counter which was seen at zero since the object was retired
+        int drainedSlots;
+    };
+
+    std::atomic<const T *> current;
+    std::atomic<int> epoch;
+    mutable std::atomic<int> readers[2];
+
+    std::vector<Retired> retired;
+    QTimer reclaimTimer;
+
+    void reclaim()
+    {
+        for (int slot = 0; slot < 2; slot++) {
+            if (this->readers[slot].load() == 0) {
+                for (Retired &retired : this->retired) {
+                    retired.drainedSlots |= 1 << slot;
+                }
+            }
+        }
+
+        this->epoch++;
+
+        auto end = std::remove_if(this->retired.begin(), this->retired.end(),
+                                  [](const Retired &retired) { return retired.drainedSlots == 3; });
+
+        this->retired.erase(end, this->retired.end());
+
+        if (this->retired.empty()) {
+            this->reclaimTimer.stop();
+        }
+    }
+};
+
+}  // namespace util
+}  // namespace chatterino
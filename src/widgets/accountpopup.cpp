@@ -37,5 +37,18 @@ void AccountPopupWidget::setName(const QString &name)
     _ui->lblUsername->setText(name);
 }
 
+void AccountPopupWidget::setMessages(
+    const std::vector<messages::UserMessageHistory::Entry> &messages)
+{
+    _ui->lstRecentMessages->clear();
+
+    for (const auto &entry : messages) {
+        _ui->lstRecentMessages->addItem(entry.time.toString("HH:mm") + " #" + entry.channelName +
+                                        ": " + entry.text);
+    }
+
+    _ui->lstRecentMessages->scrollToBottom();
+}
+
 }  // namespace widgets
 }  // namespace chatterino
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "messages/usermessagehistory.hpp"
+
 #include <QWidget>
 
 #include <memory>
@@ -21,6 +23,7 @@ public:
     AccountPopupWidget(std::shared_ptr<Channel> &channel);
 
     void setName(const QString &name);
+    void setMessages(const std::vector<messages::UserMessageHistory::Entry> &messages);
 
 private:
     Ui::AccountPopup *_ui;
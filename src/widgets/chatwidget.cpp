@@ -3,17 +3,22 @@
 #include "colorscheme.hpp"
 #include "notebookpage.hpp"
 #include "settingsmanager.hpp"
+#include "widgets/notebooktab.hpp"
+#include "widgets/searchwindow.hpp"
 #include "widgets/textinputdialog.hpp"
 
+#include <QApplication>
 #include <QDebug>
 #include <QFont>
 #include <QFontDatabase>
+#include <QMessageBox>
 #include <QPainter>
 #include <QShortcut>
 #include <QVBoxLayout>
 #include <boost/signals2.hpp>
 
 #include <functional>
+#include <queue>
 
 using namespace chatterino::messages;
 
@@ -30,6 +35,20 @@ inline void ezShortcut(ChatWidget *w, const char *key, T t)
     QObject::connect(s, &QShortcut::activated, w, t);
 }
 
+// scrollbar markers of search results, see ColorScheme::HighlightColors
+const int searchResultColorIndex = 1;
+const QString searchResultTag("search");
+
+// throttling starts once a second had this many messages and an average frame took this long
+const int throttleEnterRate = 100;
+const double throttleEnterFrameTime = 4.0;
+
+// and stops once the rate stayed below this for a few seconds
+const int throttleExitRate = 50;
+const int throttleExitSeconds = 3;
+
+const int throttledFramesPerSecond = 20;
+
 }  // namespace
 
 static int index = 0;
@@ -41,14 +60,17 @@ ChatWidget::ChatWidget(ChannelManager &_channelManager, NotebookPage *parent)
     , channel(_channelManager.emptyChannel)
     , vbox(this)
     , header(this)
+    , searchInput(this)
     , view(this)
     , input(this)
-    , channelName("/chatWidgets/" + std::to_string(index++) + "/channelName")
+    , channelName("/chatWidgets/" + std::to_string(index) + "/channelName")
+    , filterExpression("/chatWidgets/" + std::to_string(index++) + "/filter")
 {
     this->vbox.setSpacing(0);
     this->vbox.setMargin(1);
 
     this->vbox.addWidget(&this->header);
+    this->vbox.addWidget(&this->searchInput);
     this->vbox.addWidget(&this->view, 1);
     this->vbox.addWidget(&this->input);
 
@@ -62,14 +84,52 @@ ChatWidget::ChatWidget(ChannelManager &_channelManager, NotebookPage *parent)
     // CTRL+R: Change Channel
     ezShortcut(this, "CTRL+R", &ChatWidget::doChangeChannel);
 
+    // CTRL+F: Search in chat
+    ezShortcut(this, "CTRL+F", &ChatWidget::doSearch);
+
+    // CTRL+SHIFT+F: Search in all channels
+    ezShortcut(this, "CTRL+SHIFT+F", &ChatWidget::doSearchAllChannels);
+
+    // Search bar: the results are updated on every key stroke, enter jumps to the previous
+    // result, escape closes the bar
+    this->searchInput.setPlaceholderText("Search");
+    this->searchInput.hide();
+
+    QObject::connect(&this->searchInput, &QLineEdit::textChanged, this,
+                     &ChatWidget::updateSearch);
+    QObject::connect(&this->searchInput, &QLineEdit::returnPressed, this,
+                     &ChatWidget::jumpToPreviousSearchResult);
+
+    auto closeSearchShortcut = new QShortcut(QKeySequence("Escape"), &this->searchInput);
+    closeSearchShortcut->setContext(Qt::WidgetShortcut);
+    QObject::connect(closeSearchShortcut, &QShortcut::activated, this, &ChatWidget::closeSearch);
+
     this->channelName.getValueChangedSignal().connect(
         std::bind(&ChatWidget::channelNameUpdated, this, std::placeholders::_1));
 
+    this->throttleTimer.setInterval(1000);
+    QObject::connect(&this->throttleTimer, &QTimer::timeout, this, &ChatWidget::updateThrottling);
+    this->throttleTimer.start();
+
+    this->frameTimer.setInterval(1000 / throttledFramesPerSecond);
+    QObject::connect(&this->frameTimer, &QTimer::timeout, this, &ChatWidget::applyPendingLayout);
+
+    this->filterExpression.getValueChangedSignal().connect(
+        std::bind(&ChatWidget::filterExpressionUpdated, this, std::placeholders::_1));
+
+    QString errorMessage;
+
+    if (!this->filter.compile(QString::fromStdString(this->filterExpression.getValue()),
+                              errorMessage)) {
+        qDebug() << "[ChatWidget] Invalid filter:" << errorMessage;
+    }
+
     this->channelNameUpdated(this->channelName.getValue());
 }
 
 ChatWidget::~ChatWidget()
 {
+    this->setShowingChannels(false);
     this->detachChannel();
 }
 
@@ -83,68 +143,257 @@ std::shared_ptr<Channel> &ChatWidget::getChannelRef()
     return this->channel;
 }
 
-void ChatWidget::setChannel(std::shared_ptr<Channel> _newChannel)
+bool ChatWidget::showsChannel(Channel *_channel) const
 {
-    this->channel = _newChannel;
+    for (const std::shared_ptr<Channel> &shownChannel : this->channels) {
+        if (shownChannel.get() == _channel) {
+            return true;
+        }
+    }
 
-    // on new message
-    this->messageAppendedConnection =
-        this->channel->messageAppended.connect([this](SharedMessage &message) {
-            SharedMessageRef deleted;
+    return false;
+}
 
-            auto messageRef = new MessageRef(message);
+void ChatWidget::setChannels(const std::vector<std::shared_ptr<Channel>> &newChannels)
+{
+    this->channels = newChannels;
 
-            if (this->messages.appendItem(SharedMessageRef(messageRef), deleted)) {
-                qreal value = std::max(0.0, this->view.getScrollBar().getDesiredValue() - 1);
+    // the first channel is the one we type in
+    this->channel = newChannels.front();
 
-                this->view.getScrollBar().setDesiredValue(value, false);
-            }
-        });
+    for (const std::shared_ptr<Channel> &newChannel : newChannels) {
+        // on new message
+        this->channelConnections.push_back(
+            newChannel->messageAppended.connect([this](SharedMessage &message) {
+                this->appendMessage(message);
+            }));
+
+        this->channelConnections.push_back(newChannel->hibernating.connect([this] {
+            this->clearMessages();
+
+            this->reloadOnShow = true;
+        }));
+    }
 
-    // on message removed
-    this->messageRemovedConnection =
-        this->channel->messageRemovedFromStart.connect([](SharedMessage &) {
-            //
-        });
+    this->loadChannelMessages();
+}
 
-    auto snapshot = this->channel->getMessageSnapshot();
+void ChatWidget::appendMessage(SharedMessage &message)
+{
+    if (!this->filter.accepts(*message)) {
+        return;
+    }
 
-    for (int i = 0; i < snapshot.getLength(); i++) {
-        SharedMessageRef deleted;
+    this->appendedMessages++;
 
-        auto messageRef = new MessageRef(snapshot[i]);
+    if (!this->isVisible()) {
+        this->appendHiddenMessage(message);
+        return;
+    }
+
+    // All channels append in the GUI thread in the order the messages were received, so a new
+    // message is always the newest one of the merged list and the merge is just an append.
+    if (this->appendMessageRef(message)) {
+        qreal value = std::max(0.0, this->view.getScrollBar().getDesiredValue() - 1);
 
-        this->messages.appendItem(SharedMessageRef(messageRef), deleted);
+        this->view.getScrollBar().setDesiredValue(value, false);
+    }
+
+    if (message->getCanHighlightTab()) {
+        this->addScrollBarHighlight(this->messages.getSnapshot().getLength() - 1);
+        this->notifyHighlight();
+    }
+
+    // keep the results of an open search up to date
+    const QString &searchText = this->searchInput.text();
+
+    if (!searchText.isEmpty() && message->text.contains(searchText, Qt::CaseInsensitive)) {
+        this->searchResults.insert(message.get());
+        this->addSearchResultHighlight(this->messages.getSnapshot().getLength() - 1);
     }
 }
 
+bool ChatWidget::appendMessageRef(const SharedMessage &message)
+{
+    SharedMessageRef deleted;
+
+    auto messageRef = new MessageRef(message);
+    messageRef->showChannelName = this->channels.size() > 1;
+
+    this->messageSequences[message.get()].push_back(this->nextMessageSequence++);
+
+    if (!this->messages.appendItem(SharedMessageRef(messageRef), deleted)) {
+        return false;
+    }
+
+    this->view.getScrollBar().offsetHighlights(-1);
+
+    // the oldest ref is dropped, so is the oldest sequence number of its message
+    auto sequences = this->messageSequences.find(deleted->getMessage());
+
+    if (sequences != this->messageSequences.end()) {
+        sequences.value().pop_front();
+
+        if (sequences.value().empty()) {
+            this->messageSequences.erase(sequences);
+            this->searchResults.remove(deleted->getMessage());
+        }
+    }
+
+    return true;
+}
+
+void ChatWidget::clearMessages()
+{
+    this->messages.clear();
+    this->hiddenMessages.clear();
+    this->view.getScrollBar().clearHighlights();
+    this->searchResults.clear();
+    this->messageSequences.clear();
+}
+
+void ChatWidget::appendHiddenMessage(const SharedMessage &message)
+{
+    // older ones would be dropped from the split right away
+    this->hiddenMessages.push_back(message);
+
+    if (static_cast<int>(this->hiddenMessages.size()) > this->messages.getLimit()) {
+        this->hiddenMessages.pop_front();
+    }
+
+    auto page = qobject_cast<NotebookPage *>(this->parentWidget());
+
+    if (page != nullptr) {
+        page->addUnreadMessage(message);
+    }
+
+    if (message->getCanHighlightTab()) {
+        this->notifyHighlight();
+    }
+}
+
+void ChatWidget::appendHiddenMessages()
+{
+    if (this->hiddenMessages.empty()) {
+        return;
+    }
+
+    for (const SharedMessage &message : this->hiddenMessages) {
+        this->appendMessageRef(message);
+
+        if (message->getCanHighlightTab()) {
+            this->addScrollBarHighlight(this->messages.getSnapshot().getLength() - 1);
+        }
+    }
+
+    this->hiddenMessages.clear();
+
+    this->updateSearch(this->searchInput.text());
+}
+
+void ChatWidget::loadChannelMessages()
+{
+    std::vector<LimitedQueueSnapshot<SharedMessage>> snapshots;
+
+    for (const std::shared_ptr<Channel> &shownChannel : this->channels) {
+        snapshots.push_back(shownChannel->getMessageSnapshot());
+    }
+
+    // k-way merge by parse time, walking backwards from the newest message so we stop once the
+    // widget is full instead of creating refs for messages that would be dropped right away
+    using Cursor = std::pair<size_t, int>;  // snapshot, index
+
+    auto isOlder = [&snapshots](const Cursor &a, const Cursor &b) {
+        return snapshots[a.first][a.second]->getParseTime() <
+               snapshots[b.first][b.second]->getParseTime();
+    };
+
+    std::priority_queue<Cursor, std::vector<Cursor>, decltype(isOlder)> newest(isOlder);
+
+    for (size_t i = 0; i < snapshots.size(); i++) {
+        if (snapshots[i].getLength() > 0) {
+            newest.push(Cursor(i, static_cast<int>(snapshots[i].getLength()) - 1));
+        }
+    }
+
+    std::vector<SharedMessage> merged;
+
+    while (!newest.empty() && static_cast<int>(merged.size()) < this->messages.getLimit()) {
+        Cursor cursor = newest.top();
+        newest.pop();
+
+        const SharedMessage &message = snapshots[cursor.first][cursor.second];
+
+        if (this->filter.accepts(*message)) {
+            merged.push_back(message);
+        }
+
+        if (cursor.second > 0) {
+            newest.push(Cursor(cursor.first, cursor.second - 1));
+        }
+    }
+
+    for (auto it = merged.rbegin(); it != merged.rend(); ++it) {
+        this->appendMessageRef(*it);
+
+        if ((*it)->getCanHighlightTab()) {
+            this->addScrollBarHighlight(this->messages.getSnapshot().getLength() - 1);
+        }
+    }
+
+    this->updateSearch(this->searchInput.text());
+}
+
 void ChatWidget::detachChannel()
 {
-    // on message added
-    this->messageAppendedConnection.disconnect();
+    // on message added, on hibernation
+    for (boost::signals2::connection &connection : this->channelConnections) {
+        connection.disconnect();
+    }
 
-    // on message removed
-    this->messageRemovedConnection.disconnect();
+    this->channelConnections.clear();
 }
 
 void ChatWidget::channelNameUpdated(const std::string &newChannelName)
 {
-    // remove current channel
-    if (!this->channel->isEmpty()) {
-        this->channelManager.removeChannel(this->channel->name);
+    bool wasShowingChannels = this->showingChannels;
+    this->setShowingChannels(false);
 
-        this->detachChannel();
+    // remove current channels
+    for (const std::shared_ptr<Channel> &oldChannel : this->channels) {
+        this->channelManager.removeChannel(oldChannel->name);
     }
 
+    this->detachChannel();
+    this->channels.clear();
+
     // update messages
-    this->messages.clear();
+    this->clearMessages();
+
+    // "forsen, pajlada" shows both channels merged into one split
+    std::vector<std::shared_ptr<Channel>> newChannels;
+    QStringList addedNames;
 
-    if (newChannelName.empty()) {
+    for (const QString &name : QString::fromStdString(newChannelName).split(',')) {
+        QString trimmedName = name.trimmed();
+
+        if (trimmedName.isEmpty() || addedNames.contains(trimmedName, Qt::CaseInsensitive)) {
+            continue;
+        }
+
+        addedNames.append(trimmedName);
+        newChannels.push_back(this->channelManager.addChannel(trimmedName));
+    }
+
+    if (newChannels.empty()) {
         this->channel = this->channelManager.emptyChannel;
     } else {
-        this->setChannel(this->channelManager.addChannel(QString::fromStdString(newChannelName)));
+        this->setChannels(newChannels);
     }
 
+    this->reloadOnShow = false;
+    this->setShowingChannels(wasShowingChannels);
+
     // update header
     this->header.updateChannelText();
 
@@ -152,6 +401,115 @@ void ChatWidget::channelNameUpdated(const std::string &newChannelName)
     this->layoutMessages(true);
 }
 
+void ChatWidget::filterExpressionUpdated(const std::string &newFilterExpression)
+{
+    QString errorMessage;
+
+    if (!this->filter.compile(QString::fromStdString(newFilterExpression), errorMessage)) {
+        qDebug() << "[ChatWidget] Invalid filter:" << errorMessage;
+        return;
+    }
+
+    // the messages filtered out before aren't stored anywhere else, take them from the channel
+    this->clearMessages();
+
+    this->loadChannelMessages();
+
+    this->layoutMessages(true);
+}
+
+void ChatWidget::addScrollBarHighlight(int messageIndex)
+{
+    ScrollBar &scrollBar = this->view.getScrollBar();
+
+    scrollBar.addHighlight(new ScrollBarHighlight(messageIndex, 0, &scrollBar));
+}
+
+void ChatWidget::addSearchResultHighlight(int messageIndex)
+{
+    ScrollBar &scrollBar = this->view.getScrollBar();
+
+    scrollBar.addHighlight(new ScrollBarHighlight(messageIndex, searchResultColorIndex, &scrollBar,
+                                                  ScrollBarHighlight::Right, searchResultTag));
+}
+
+void ChatWidget::updateSearch(const QString &text)
+{
+    this->searchResults.clear();
+    this->view.getScrollBar().removeHighlightsWhere(
+        [](ScrollBarHighlight &highlight) { return highlight.getTag() == searchResultTag; });
+
+    if (text.isEmpty()) {
+        return;
+    }
+
+    // the messages are appended without gaps, the oldest one left has this sequence number
+    quint64 firstSequence = this->nextMessageSequence - this->messages.getSnapshot().getLength();
+
+    // the channels' indexes find the results, the markers need their position in this widget
+    for (const std::shared_ptr<Channel> &shownChannel : this->channels) {
+        for (Message *message : shownChannel->search(text)) {
+            auto sequences = this->messageSequences.constFind(message);
+
+            // filtered out, not shown anymore, or found in another shown channel already
+            if (sequences == this->messageSequences.constEnd() ||
+                this->searchResults.contains(message)) {
+                continue;
+            }
+
+            this->searchResults.insert(message);
+
+            for (quint64 sequence : sequences.value()) {
+                this->addSearchResultHighlight(static_cast<int>(sequence - firstSequence));
+            }
+        }
+    }
+}
+
+void ChatWidget::jumpToPreviousSearchResult()
+{
+    auto snapshot = this->messages.getSnapshot();
+    int count = snapshot.getLength();
+
+    if (this->searchResults.isEmpty() || count == 0) {
+        return;
+    }
+
+    ScrollBar &scrollBar = this->view.getScrollBar();
+    int current = std::min(static_cast<int>(scrollBar.getDesiredValue()), count);
+
+    // search upwards from the top message, wrapping around to the newest one
+    for (int i = 1; i <= count; i++) {
+        int index = (current - i + count) % count;
+
+        if (this->searchResults.contains(snapshot[index]->getMessage())) {
+            scrollBar.setDesiredValue(index, true);
+            return;
+        }
+    }
+}
+
+void ChatWidget::closeSearch()
+{
+    this->searchInput.clear();
+    this->searchInput.hide();
+
+    this->giveFocus();
+}
+
+void ChatWidget::notifyHighlight()
+{
+    auto page = qobject_cast<NotebookPage *>(this->parentWidget());
+
+    if (page != nullptr && !page->getTab()->getSelected()) {
+        page->getTab()->setHighlightStyle(NotebookTab::HighlightHighlighted);
+    }
+
+    if (SettingsManager::getInstance().enableHighlightTaskbar.get()) {
+        QApplication::alert(this->window());
+    }
+}
+
 LimitedQueueSnapshot<SharedMessageRef> ChatWidget::getMessagesSnapshot()
 {
     return this->messages.getSnapshot();
@@ -171,13 +529,94 @@ void ChatWidget::showChangeChannelPopup()
     }
 }
 
+void ChatWidget::showSetFilterPopup()
+{
+    TextInputDialog dialog(this);
+
+    dialog.setWindowTitle("Filter");
+    dialog.setText(QString::fromStdString(this->filterExpression));
+
+    while (dialog.exec() == QDialog::Accepted) {
+        QString newFilterExpression = dialog.getText().trimmed();
+
+        // check the expression before storing it, so the user can fix typos
+        MessageFilter newFilter;
+        QString errorMessage;
+
+        if (newFilter.compile(newFilterExpression, errorMessage)) {
+            this->filterExpression = newFilterExpression.toStdString();
+            return;
+        }
+
+        QMessageBox::warning(this, "Invalid filter", errorMessage);
+    }
+}
+
 void ChatWidget::layoutMessages(bool forceUpdate)
 {
+    if (this->throttled) {
+        this->layoutPending = true;
+        return;
+    }
+
     if (this->view.layoutMessages() || forceUpdate) {
         this->view.update();
     }
 }
 
+void ChatWidget::updateThrottling()
+{
+    int rate = this->appendedMessages;
+    double frameTime = this->view.takeAverageFrameTime();
+
+    this->appendedMessages = 0;
+
+    bool enabled = SettingsManager::getInstance().enableFastChatThrottling.get();
+
+    if (!this->throttled) {
+        if (enabled && rate >= throttleEnterRate && frameTime >= throttleEnterFrameTime) {
+            qDebug() << "[ChatWidget] Throttling" << QString::fromStdString(this->channelName)
+                     << rate << "messages/s," << frameTime << "ms/frame";
+
+            this->throttled = true;
+            this->calmSeconds = 0;
+
+            this->view.setFastForward(true);
+            this->frameTimer.start();
+        }
+
+        return;
+    }
+
+    // throttled frames take longer by design, only the rate tells whether the chat calmed down
+    if (rate < throttleExitRate) {
+        this->calmSeconds++;
+    } else {
+        this->calmSeconds = 0;
+    }
+
+    if (!enabled || this->calmSeconds >= throttleExitSeconds) {
+        this->throttled = false;
+
+        this->frameTimer.stop();
+        this->view.setFastForward(false);
+
+        this->applyPendingLayout();
+    }
+}
+
+void ChatWidget::applyPendingLayout()
+{
+    if (!this->layoutPending) {
+        return;
+    }
+
+    this->layoutPending = false;
+
+    this->view.layoutMessages();
+    this->view.update();
+}
+
 void ChatWidget::updateGifEmotes()
 {
     this->view.updateGifEmotes();
@@ -196,6 +635,50 @@ void ChatWidget::paintEvent(QPaintEvent *)
     painter.fillRect(this->rect(), this->colorScheme.ChatBackground);
 }
 
+void ChatWidget::setShowingChannels(bool value)
+{
+    if (this->showingChannels == value) {
+        return;
+    }
+
+    this->showingChannels = value;
+
+    for (const std::shared_ptr<Channel> &shownChannel : this->channels) {
+        if (value) {
+            shownChannel->viewShown();
+        } else {
+            shownChannel->viewHidden();
+        }
+    }
+}
+
+void ChatWidget::showEvent(QShowEvent *)
+{
+    this->setShowingChannels(true);
+
+    if (this->reloadOnShow) {
+        // the queued messages are in the channels as well
+        this->reloadOnShow = false;
+        this->hiddenMessages.clear();
+
+        this->loadChannelMessages();
+    } else {
+        this->appendHiddenMessages();
+    }
+
+    // the viewport right away, everything above it on the thread pool
+    this->layoutMessages(true);
+
+    this->view.startBackgroundLayout();
+}
+
+void ChatWidget::hideEvent(QHideEvent *)
+{
+    this->view.stopBackgroundLayout();
+
+    this->setShowingChannels(false);
+}
+
 void ChatWidget::load(const boost::property_tree::ptree &tree)
 {
     // load tab text
@@ -203,6 +686,11 @@ void ChatWidget::load(const boost::property_tree::ptree &tree)
         this->channelName = tree.get<std::string>("channelName");
     } catch (boost::property_tree::ptree_error) {
     }
+
+    try {
+        this->filterExpression = tree.get<std::string>("filter");
+    } catch (boost::property_tree::ptree_error) {
+    }
 }
 
 boost::property_tree::ptree ChatWidget::save()
@@ -210,6 +698,7 @@ boost::property_tree::ptree ChatWidget::save()
     boost::property_tree::ptree tree;
 
     tree.put("channelName", this->channelName.getValue());
+    tree.put("filter", this->filterExpression.getValue());
 
     return tree;
 }
@@ -232,11 +721,29 @@ void ChatWidget::doChangeChannel()
     this->showChangeChannelPopup();
 }
 
+void ChatWidget::doSetFilter()
+{
+    this->showSetFilterPopup();
+}
+
+void ChatWidget::doSearchAllChannels()
+{
+    SearchWindow::showWindow(this->channelManager);
+}
+
+void ChatWidget::doSearch()
+{
+    this->searchInput.show();
+    this->searchInput.setFocus();
+    this->searchInput.selectAll();
+}
+
 void ChatWidget::doPopup()
 {
     // TODO: Copy signals and stuff too
     auto widget =
         new ChatWidget(this->channelManager, static_cast<NotebookPage *>(this->parentWidget()));
+    widget->filterExpression = this->filterExpression;
     widget->channelName = this->channelName;
     widget->show();
 }
@@ -244,7 +751,7 @@ void ChatWidget::doPopup()
 void ChatWidget::doClearChat()
 {
     // Clear all stored messages in this chat widget
-    this->messages.clear();
+    this->clearMessages();
 
     // Layout chat widget messages, and force an update regardless if there are no messages
     this->layoutMessages(true);
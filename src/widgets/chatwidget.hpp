@@ -2,6 +2,7 @@
 
 #include "channel.hpp"
 #include "messages/limitedqueuesnapshot.hpp"
+#include "messages/messagefilter.hpp"
 #include "messages/messageref.hpp"
 #include "messages/word.hpp"
 #include "messages/wordpart.hpp"
@@ -11,12 +12,19 @@
 #include "widgets/chatwidgetview.hpp"
 
 #include <QFont>
+#include <QLineEdit>
+#include <QHash>
+#include <QSet>
 #include <QShortcut>
+#include <QTimer>
 #include <QVBoxLayout>
 #include <QWidget>
 #include <boost/property_tree/ptree.hpp>
 #include <boost/signals2/connection.hpp>
 
+#include <deque>
+#include <vector>
+
 namespace chatterino {
 
 class ChannelManager;
@@ -45,10 +53,15 @@ public:
     ChatWidget(ChannelManager &_channelManager, NotebookPage *parent);
     ~ChatWidget();
 
+    // The channel messages are sent to, the first one of a merged split
     std::shared_ptr<Channel> getChannel() const;
     std::shared_ptr<Channel> &getChannelRef();
 
+    // Whether the split shows messages of the channel, merged splits show more than one
+    bool showsChannel(Channel *_channel) const;
+
     void showChangeChannelPopup();
+    void showSetFilterPopup();
     messages::LimitedQueueSnapshot<messages::SharedMessageRef> getMessagesSnapshot();
     void layoutMessages(bool forceUpdate = false);
     void updateGifEmotes();
@@ -57,30 +70,94 @@ public:
 
     pajlada::Settings::Setting<std::string> channelName;
 
+    // Only messages matching this expression are shown, see MessageFilter
+    pajlada::Settings::Setting<std::string> filterExpression;
+
 protected:
     virtual void paintEvent(QPaintEvent *) override;
+    virtual void showEvent(QShowEvent *) override;
+    virtual void hideEvent(QHideEvent *) override;
 
 public:
     ChannelManager &channelManager;
     CompletionManager &completionManager;
 
 private:
-    void setChannel(std::shared_ptr<Channel> newChannel);
+    void setChannels(const std::vector<std::shared_ptr<Channel>> &newChannels);
     void detachChannel();
 
     void channelNameUpdated(const std::string &newChannelName);
+    void filterExpressionUpdated(const std::string &newFilterExpression);
+
+    // Adds the messages the channel already has, i.e. after switching channels or filters
+    void loadChannelMessages();
+    void appendMessage(messages::SharedMessage &message);
+
+    // Returns true if the oldest message was dropped to make room
+    bool appendMessageRef(const messages::SharedMessage &message);
+    void clearMessages();
+
+    // Hidden splits only queue their messages, they're added once the split is shown
+    void appendHiddenMessage(const messages::SharedMessage &message);
+    void appendHiddenMessages();
+
+    void addScrollBarHighlight(int messageIndex);
+    void addSearchResultHighlight(int messageIndex);
+
+    void updateSearch(const QString &text);
+    void jumpToPreviousSearchResult();
+    void closeSearch();
+
+    // Highlights the tab of our page and flashes the taskbar entry
+    void notifyHighlight();
+
+    // Switches throttling on or off depending on the load of the last second
+    void updateThrottling();
+    void applyPendingLayout();
 
     messages::LimitedQueue<messages::SharedMessageRef> messages;
 
     std::shared_ptr<Channel> channel;
+    std::vector<std::shared_ptr<Channel>> channels;
 
     QVBoxLayout vbox;
     ChatWidgetHeader header;
+    QLineEdit searchInput;
     ChatWidgetView view;
     ChatWidgetInput input;
 
-    boost::signals2::connection messageAppendedConnection;
-    boost::signals2::connection messageRemovedConnection;
+    std::vector<boost::signals2::connection> channelConnections;
+
+    // whether the channels were told that we show them, see Channel::viewShown
+    bool showingChannels = false;
+
+    // a channel hibernated while we were hidden, its messages are taken again once we're shown
+    bool reloadOnShow = false;
+
+    void setShowingChannels(bool value);
+
+    messages::MessageFilter filter;
+
+    // Very fast chats would lay out and repaint the split for every message. While the message
+    // rate and the frame time are both too high, updates are collected and applied at a fixed
+    // frame rate instead, until the chat calms down again.
+    QTimer throttleTimer;
+    QTimer frameTimer;
+    bool throttled = false;
+    bool layoutPending = false;
+    int appendedMessages = 0;
+    int calmSeconds = 0;
+
+    std::deque<messages::SharedMessage> hiddenMessages;
+
+    // messages matching the text in searchInput
+    QSet<messages::Message *> searchResults;
+
+    // message -> the sequence numbers of its refs in this split, oldest first. A merged split
+    // shows a message twice if it's also in /mentions. Messages are only appended and dropped
+    // oldest first, so a ref's position is its number minus the oldest one's.
+    QHash<messages::Message *, std::deque<quint64>> messageSequences;
+    quint64 nextMessageSequence = 0;
 
 public:
     void load(const boost::property_tree::ptree &tree);
@@ -97,6 +174,15 @@ public slots:
     // Show a dialog for changing the current splits/chat widgets channel
     void doChangeChannel();
 
+    // Show a dialog for changing the filter of this split
+    void doSetFilter();
+
+    // Show the search bar, matching messages are marked on the scrollbar
+    void doSearch();
+
+    // Open the window searching all open channels
+    void doSearchAllChannels();
+
     // Open popup copy of this chat widget
     // XXX: maybe make current chatwidget a popup instead?
     void doPopup();
@@ -47,6 +47,7 @@ ChatWidgetHeader::ChatWidgetHeader(ChatWidget *_chatWidget)
     this->leftMenu.addSeparator();
     this->leftMenu.addAction("Change channel", this->chatWidget, &ChatWidget::doChangeChannel,
                              QKeySequence(tr("Ctrl+R")));
+    this->leftMenu.addAction("Set filter", this->chatWidget, &ChatWidget::doSetFilter);
     this->leftMenu.addAction("Clear chat", this->chatWidget, &ChatWidget::doClearChat);
     this->leftMenu.addAction("Open channel", this->chatWidget, &ChatWidget::doOpenChannel);
     this->leftMenu.addAction("Open popup player", this->chatWidget, &ChatWidget::doOpenPopupPlayer);
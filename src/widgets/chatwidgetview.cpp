@@ -1,4 +1,5 @@
 #include "widgets/chatwidgetview.hpp"
+#include "asyncexec.hpp"
 #include "channelmanager.hpp"
 #include "colorscheme.hpp"
 #include "messages/message.hpp"
@@ -10,6 +11,7 @@
 
 #include <QDebug>
 #include <QDesktopServices>
+#include <QElapsedTimer>
 #include <QGraphicsBlurEffect>
 #include <QPainter>
 
@@ -20,6 +22,28 @@
 namespace chatterino {
 namespace widgets {
 
+namespace {
+
+// time spent collecting words per slice of a background layout, in nanoseconds
+const qint64 backgroundLayoutTimeBudget = 2 * 1000 * 1000;
+
+// messages laid out per task
+const size_t backgroundLayoutBatchSize = 64;
+
+// milliseconds between checks for finished tasks, once everything was handed out
+const int backgroundLayoutPollInterval = 10;
+
+// a resize counts as finished once the width stayed the same for this many milliseconds
+const int resizeSettleTime = 200;
+
+}  // namespace
+
+ChatWidgetView::BackgroundLayout::BackgroundLayout()
+    : cancelled(false)
+    , remainingTasks(0)
+{
+}
+
 ChatWidgetView::ChatWidgetView(ChatWidget *_chatWidget)
     : BaseWidget(_chatWidget)
     , chatWidget(_chatWidget)
@@ -36,15 +60,40 @@ ChatWidgetView::ChatWidgetView(ChatWidget *_chatWidget)
         // Whenever the scrollbar value has been changed, re-render the ChatWidgetView
         this->update();
     });
+
+    QObject::connect(&this->backgroundLayoutTimer, &QTimer::timeout, this,
+                     &ChatWidgetView::continueBackgroundLayout);
+
+    this->resizeSettleTimer.setSingleShot(true);
+    this->resizeSettleTimer.setInterval(resizeSettleTime);
+    QObject::connect(&this->resizeSettleTimer, &QTimer::timeout, this, [this] {
+        if (this->isVisible()) {
+            this->startBackgroundLayout();
+        }
+    });
 }
 
 ChatWidgetView::~ChatWidgetView()
 {
+    this->stopBackgroundLayout();
+
     QObject::disconnect(&SettingsManager::getInstance(), &SettingsManager::wordTypeMaskChanged,
                         this, &ChatWidgetView::wordTypeMaskChanged);
 }
 
 bool ChatWidgetView::layoutMessages()
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    bool redraw = this->layoutMessagesInternal();
+
+    this->frameTimeTotal += timer.nsecsElapsed();
+
+    return redraw;
+}
+
+bool ChatWidgetView::layoutMessagesInternal()
 {
     auto messages = this->chatWidget->getMessagesSnapshot();
 
@@ -63,10 +112,14 @@ bool ChatWidgetView::layoutMessages()
     this->showingLatestMessages = this->scrollBar.isAtBottom() || !this->scrollBar.isVisible();
 
     int start = this->scrollBar.getCurrentValue();
-    int layoutWidth = this->scrollBar.isVisible() ? width() - this->scrollBar.width() : width();
+    int layoutWidth = this->getLayoutWidth();
+
+    // Fast forwarding to the newest messages, the ones at the old scroll position would be
+    // scrolled past right away. The loop below lays out the newest ones.
+    bool skipVisibleMessages = this->fastForward && this->showingLatestMessages;
 
     // layout the visible messages in the view
-    if (messages.getLength() > start) {
+    if (messages.getLength() > start && !skipVisibleMessages) {
         int y = -(messages[start]->getHeight() * (fmod(this->scrollBar.getCurrentValue(), 1)));
 
         for (int i = start; i < messages.getLength(); ++i) {
@@ -119,7 +172,178 @@ bool ChatWidgetView::layoutMessages()
         this->scrollBar.scrollToBottom();
     }
 
-    return redraw;
+    return redraw || skipVisibleMessages;
+}
+
+int ChatWidgetView::getLayoutWidth() const
+{
+    return this->scrollBar.isVisible() ? width() - this->scrollBar.width() : width();
+}
+
+void ChatWidgetView::startBackgroundLayout()
+{
+    this->stopBackgroundLayout();
+
+    this->backgroundLayout = std::make_shared<BackgroundLayout>();
+    this->backgroundLayoutIndex = this->chatWidget->getMessagesSnapshot().getLength();
+    this->backgroundLayoutWidth = this->getLayoutWidth();
+
+    // a zero interval timer fires whenever there are no other events to process
+    this->backgroundLayoutTimer.setInterval(0);
+    this->backgroundLayoutTimer.start();
+}
+
+void ChatWidgetView::stopBackgroundLayout()
+{
+    this->backgroundLayoutTimer.stop();
+    this->resizeSettleTimer.stop();
+
+    if (this->backgroundLayout) {
+        // running tasks finish on their own, nobody collects their results
+        this->backgroundLayout->cancelled = true;
+        this->backgroundLayout.reset();
+    }
+
+    this->backgroundLayoutBatches.clear();
+}
+
+void ChatWidgetView::continueBackgroundLayout()
+{
+    int layoutWidth = this->getLayoutWidth();
+
+    if (layoutWidth != this->backgroundLayoutWidth) {
+        // i.e. the scrollbar was shown, everything handed out so far is outdated
+        this->startBackgroundLayout();
+        return;
+    }
+
+    bool done = this->backgroundLayoutIndex == 0 && this->backgroundLayout->remainingTasks == 0;
+
+    this->applyBackgroundLayouts();
+
+    if (done) {
+        this->stopBackgroundLayout();
+        return;
+    }
+
+    auto messages = this->chatWidget->getMessagesSnapshot();
+
+    QElapsedTimer timer;
+    timer.start();
+
+    int index = std::min(this->backgroundLayoutIndex, static_cast<int>(messages.getLength()));
+
+    while (index > 0 && timer.nsecsElapsed() < backgroundLayoutTimeBudget) {
+        std::vector<messages::SharedMessageRef> batch;
+        auto inputs = std::make_shared<std::vector<messages::MessageRef::LayoutInput>>();
+
+        while (index > 0 && batch.size() < backgroundLayoutBatchSize &&
+               timer.nsecsElapsed() < backgroundLayoutTimeBudget) {
+            index--;
+
+            const messages::SharedMessageRef &message = messages[index];
+
+            if (message->isLayoutValid(layoutWidth) || message->restoreLayout(layoutWidth)) {
+                continue;
+            }
+
+            inputs->push_back(message->prepareLayout(layoutWidth, true));
+            batch.push_back(message);
+        }
+
+        if (batch.empty()) {
+            continue;
+        }
+
+        int batchId = this->nextBatchId++;
+        this->backgroundLayoutBatches[batchId] = std::move(batch);
+
+        auto layout = this->backgroundLayout;
+        layout->remainingTasks++;
+
+        // async_exec is a macro, the capture list's commas can't be inside of it
+        auto task = [layout, inputs, batchId] {
+            std::vector<messages::MessageRef::LayoutResult> results;
+            results.reserve(inputs->size());
+
+            for (messages::MessageRef::LayoutInput &input : *inputs) {
+                if (layout->cancelled) {
+                    break;
+                }
+
+                results.push_back(messages::MessageRef::computeLayout(std::move(input)));
+            }
+
+            {
+                QMutexLocker lock(&layout->mutex);
+
+                layout->finishedBatches.emplace_back(batchId, std::move(results));
+            }
+
+            layout->remainingTasks--;
+        };
+
+        async_exec(task);
+    }
+
+    this->backgroundLayoutIndex = index;
+
+    if (index == 0) {
+        // only waiting for the tasks from now on
+        this->backgroundLayoutTimer.setInterval(backgroundLayoutPollInterval);
+    }
+}
+
+void ChatWidgetView::applyBackgroundLayouts()
+{
+    std::vector<std::pair<int, std::vector<messages::MessageRef::LayoutResult>>> finished;
+
+    {
+        QMutexLocker lock(&this->backgroundLayout->mutex);
+
+        finished.swap(this->backgroundLayout->finishedBatches);
+    }
+
+    int layoutWidth = this->getLayoutWidth();
+
+    for (auto &finishedBatch : finished) {
+        auto batch = this->backgroundLayoutBatches.find(finishedBatch.first);
+
+        if (batch == this->backgroundLayoutBatches.end()) {
+            continue;
+        }
+
+        std::vector<messages::SharedMessageRef> &refs = batch->second;
+        std::vector<messages::MessageRef::LayoutResult> &results = finishedBatch.second;
+
+        for (size_t i = 0; i < results.size() && i < refs.size(); i++) {
+            // messages scrolled into view were laid out on the GUI thread in the meantime
+            if (results[i].width == layoutWidth && !refs[i]->isLayoutValid(layoutWidth)) {
+                refs[i]->applyLayout(results[i]);
+            }
+        }
+
+        this->backgroundLayoutBatches.erase(batch);
+    }
+}
+
+void ChatWidgetView::setFastForward(bool value)
+{
+    if (this->fastForward != value) {
+        this->fastForward = value;
+
+        this->update();
+    }
+}
+
+double ChatWidgetView::takeAverageFrameTime()
+{
+    double average = this->frameCount == 0 ? 0.0 : this->frameTimeTotal / 1e6 / this->frameCount;
+
+    this->frameTimeTotal = 0;
+    this->frameCount = 0;
+
+    return average;
 }
 
 void ChatWidgetView::updateGifEmotes()
@@ -138,12 +362,34 @@ void ChatWidgetView::resizeEvent(QResizeEvent *)
     this->scrollBar.resize(this->scrollBar.width(), height());
     this->scrollBar.move(width() - this->scrollBar.width(), 0);
 
-    layoutMessages();
+    // messages which are already laid out at this width return right away, so resizes which keep
+    // the width don't lay anything out. The resized view is repainted by Qt either way.
+    if (this->layoutMessages()) {
+        this->update();
+    }
 
-    this->update();
+    // while the width keeps changing (i.e. the window is being resized) only the visible
+    // messages are laid out, everything else once it settled
+    if (this->isVisible() && this->getLayoutWidth() != this->backgroundLayoutWidth) {
+        this->stopBackgroundLayout();
+        this->backgroundLayoutWidth = this->getLayoutWidth();
+
+        this->resizeSettleTimer.start();
+    }
 }
 
 void ChatWidgetView::paintEvent(QPaintEvent * /*event*/)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    this->paintMessages();
+
+    this->frameTimeTotal += timer.nsecsElapsed();
+    this->frameCount++;
+}
+
+void ChatWidgetView::paintMessages()
 {
     QPainter _painter(this);
 
@@ -154,7 +400,7 @@ void ChatWidgetView::paintEvent(QPaintEvent * /*event*/)
         this->onlyUpdateEmotes = false;
 
         for (const GifEmoteData &item : this->gifEmotes) {
-            _painter.fillRect(item.rect, this->colorScheme.ChatBackground);
+            _painter.fillRect(item.rect, item.background);
 
             _painter.drawPixmap(item.rect, *item.image->getPixmap());
         }
@@ -218,6 +464,17 @@ void ChatWidgetView::paintEvent(QPaintEvent * /*event*/)
 
         bool updateBuffer = messageRef->updateBuffer;
 
+        const QColor &background = messageRef->getMessage()->getCanHighlightTab()
+                                       ? this->colorScheme.ChatBackgroundHighlighted
+                                       : this->colorScheme.ChatBackground;
+
+        // timeouts and /clear only redraw the messages they disabled
+        bool disabled = messageRef->getMessage()->isDisabled();
+
+        if (disabled != messageRef->bufferDisabled) {
+            updateBuffer = true;
+        }
+
         if (buffer == nullptr) {
             buffer = new QPixmap(width(), messageRef->getHeight());
             bufferPtr = std::shared_ptr<QPixmap>(buffer);
@@ -227,7 +484,7 @@ void ChatWidgetView::paintEvent(QPaintEvent * /*event*/)
         // update messages that have been changed
         if (updateBuffer) {
             QPainter painter(buffer);
-            painter.fillRect(buffer->rect(), this->colorScheme.ChatBackground);
+            painter.fillRect(buffer->rect(), background);
 
             for (messages::WordPart const &wordPart : messageRef->getWordParts()) {
                 // image
@@ -256,17 +513,27 @@ void ChatWidgetView::paintEvent(QPaintEvent * /*event*/)
                 }
             }
 
+            // fade out disabled messages
+            if (disabled) {
+                QColor fade = background;
+                fade.setAlpha(160);
+
+                painter.fillRect(buffer->rect(), fade);
+            }
+
             messageRef->updateBuffer = false;
+            messageRef->bufferDisabled = disabled;
         }
 
-        // get gif emotes
+        // get gif emotes, disabled messages keep the faded first frame
         for (messages::WordPart const &wordPart : messageRef->getWordParts()) {
-            if (wordPart.getWord().isImage()) {
+            if (!disabled && wordPart.getWord().isImage()) {
                 messages::LazyLoadedImage &lli = wordPart.getWord().getImage();
 
                 if (lli.getAnimated()) {
                     GifEmoteData gifEmoteData;
                     gifEmoteData.image = &lli;
+                    gifEmoteData.background = background;
                     QRect rect(wordPart.getX(), wordPart.getY() + y, wordPart.getWidth(),
                                wordPart.getHeight());
 
@@ -289,10 +556,21 @@ void ChatWidgetView::paintEvent(QPaintEvent * /*event*/)
     }
 
     for (GifEmoteData &item : this->gifEmotes) {
-        _painter.fillRect(item.rect, this->colorScheme.ChatBackground);
+        _painter.fillRect(item.rect, item.background);
 
         _painter.drawPixmap(item.rect, *item.image->getPixmap());
     }
+
+    if (this->fastForward) {
+        QString text("Fast chat, updates limited");
+
+        QRect rect = _painter.fontMetrics().boundingRect(text).adjusted(-6, -3, 6, 3);
+        rect.moveTopRight(QPoint(this->width() - this->scrollBar.width() - 4, 4));
+
+        _painter.fillRect(rect, this->colorScheme.TooltipBackground);
+        _painter.setPen(this->colorScheme.TooltipText);
+        _painter.drawText(rect, Qt::AlignCenter, text);
+    }
 }
 
 void ChatWidgetView::wheelEvent(QWheelEvent *event)
@@ -384,6 +662,8 @@ void ChatWidgetView::mouseReleaseEvent(QMouseEvent *event)
         case messages::Link::UserInfo:{
             auto user = message->getMessage()->getUserName();
             this->userPopupWidget.setName(user);
+            this->userPopupWidget.setMessages(
+                this->chatWidget->channelManager.userMessageHistory.getMessages(user));
             this->userPopupWidget.move(event->screenPos().toPoint());
             this->userPopupWidget.show();
             this->userPopupWidget.setFocus();
@@ -8,11 +8,18 @@
 #include "widgets/basewidget.hpp"
 #include "widgets/scrollbar.hpp"
 
+#include <QMutex>
 #include <QPaintEvent>
 #include <QScroller>
+#include <QTimer>
 #include <QWheelEvent>
 #include <QWidget>
 
+#include <atomic>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
 namespace chatterino {
 namespace widgets {
 
@@ -26,6 +33,20 @@ public:
 
     bool layoutMessages();
 
+    // While fast forwarding, only the newest messages are laid out when new ones arrive instead
+    // of scrolling through everything in between. Shows an indicator on top of the messages.
+    void setFastForward(bool value);
+
+    // Lays out all messages which aren't up to date, newest first, i.e. after the split was shown
+    // or resized. The words are collected in short slices on the GUI thread, measuring and
+    // positioning them happens on the thread pool. Messages keep their old layout until the new
+    // one is done. Starting again cancels the running one.
+    void startBackgroundLayout();
+    void stopBackgroundLayout();
+
+    // Average milliseconds spent laying out and painting a frame since the last call
+    double takeAverageFrameTime();
+
     void updateGifEmotes();
     ScrollBar &getScrollBar();
 
@@ -33,6 +54,7 @@ protected:
     virtual void resizeEvent(QResizeEvent *) override;
 
     virtual void paintEvent(QPaintEvent *) override;
+    void paintMessages();
     virtual void wheelEvent(QWheelEvent *event) override;
 
     virtual void mouseMoveEvent(QMouseEvent *event) override;
@@ -46,6 +68,7 @@ private:
     struct GifEmoteData {
         messages::LazyLoadedImage *image;
         QRect rect;
+        QColor background;
     };
 
     std::vector<GifEmoteData> gifEmotes;
@@ -61,6 +84,41 @@ private:
     AccountPopupWidget userPopupWidget;
     bool onlyUpdateEmotes = false;
 
+    bool fastForward = false;
+
+    bool layoutMessagesInternal();
+    int getLayoutWidth() const;
+
+    qint64 frameTimeTotal = 0;
+    int frameCount = 0;
+
+    // Shared with the layout tasks, which never touch the view or the messages
+    struct BackgroundLayout {
+        std::atomic<bool> cancelled;
+        std::atomic<int> remainingTasks;
+
+        QMutex mutex;
+        std::vector<std::pair<int, std::vector<messages::MessageRef::LayoutResult>>>
+            finishedBatches;
+
+        BackgroundLayout();
+    };
+
+    std::shared_ptr<BackgroundLayout> backgroundLayout;
+    QTimer backgroundLayoutTimer;
+    int backgroundLayoutIndex = 0;
+    int backgroundLayoutWidth = -1;
+
+    // restarted on every width change, the background layout starts once it fires
+    QTimer resizeSettleTimer;
+
+    // batch id -> messages of the batch, so the refs are never released on a worker thread
+    std::unordered_map<int, std::vector<messages::SharedMessageRef>> backgroundLayoutBatches;
+    int nextBatchId = 0;
+
+    void continueBackgroundLayout();
+    void applyBackgroundLayouts();
+
     // Mouse event variables
     bool isMouseDown = false;
     QPointF lastPressPosition;
@@ -70,6 +128,10 @@ private slots:
     {
         layoutMessages();
         update();
+
+        if (this->isVisible()) {
+            this->startBackgroundLayout();
+        }
     }
 };
 
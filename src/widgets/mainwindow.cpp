@@ -83,7 +83,7 @@ void MainWindow::layoutVisibleChatWidgets(Channel *channel)
     for (auto it = widgets.begin(); it != widgets.end(); ++it) {
         ChatWidget *widget = *it;
 
-        if (channel == nullptr || channel == widget->getChannel().get()) {
+        if (channel == nullptr || widget->showsChannel(channel)) {
             widget->layoutMessages();
         }
     }
@@ -102,7 +102,7 @@ void MainWindow::repaintVisibleChatWidgets(Channel *channel)
     for (auto it = widgets.begin(); it != widgets.end(); ++it) {
         ChatWidget *widget = *it;
 
-        if (channel == nullptr || channel == widget->getChannel().get()) {
+        if (channel == nullptr || widget->showsChannel(channel)) {
             widget->layoutMessages();
         }
     }
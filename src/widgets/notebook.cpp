@@ -97,6 +97,8 @@ void Notebook::select(NotebookPage *page)
     if (page != nullptr) {
         page->setHidden(false);
         page->getTab()->setSelected(true);
+        page->getTab()->setHighlightStyle(NotebookTab::HighlightNone);
+        page->getTab()->setUnreadCount(0);
         page->getTab()->raise();
     }
 
@@ -18,6 +18,13 @@
 namespace chatterino {
 namespace widgets {
 
+namespace {
+
+// more than the number of splits a page could fit
+const size_t recentUnreadMessageCount = 32;
+
+}  // namespace
+
 bool NotebookPage::isDraggingSplit = false;
 ChatWidget *NotebookPage::draggingSplit = nullptr;
 std::pair<int, int> NotebookPage::dropPosition = std::pair<int, int>(-1, -1);
@@ -118,6 +125,26 @@ NotebookTab *NotebookPage::getTab() const
     return this->tab;
 }
 
+void NotebookPage::addUnreadMessage(const messages::SharedMessage &message)
+{
+    if (std::find(this->recentUnreadMessages.begin(), this->recentUnreadMessages.end(),
+                  message) != this->recentUnreadMessages.end()) {
+        return;
+    }
+
+    this->recentUnreadMessages.push_back(message);
+
+    if (this->recentUnreadMessages.size() > recentUnreadMessageCount) {
+        this->recentUnreadMessages.pop_front();
+    }
+
+    this->tab->setUnreadCount(this->tab->getUnreadCount() + 1);
+
+    if (this->tab->getHighlightStyle() == NotebookTab::HighlightNone) {
+        this->tab->setHighlightStyle(NotebookTab::HighlightNewMessage);
+    }
+}
+
 void NotebookPage::addChat(bool openChannelNameDialog)
 {
     ChatWidget *w = this->createChatWidget();
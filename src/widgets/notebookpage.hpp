@@ -15,6 +15,8 @@
 #include <boost/property_tree/ptree.hpp>
 #include <boost/signals2.hpp>
 
+#include <deque>
+
 namespace chatterino {
 
 class ChannelManager;
@@ -38,6 +40,10 @@ public:
     const std::vector<ChatWidget *> &getChatWidgets() const;
     NotebookTab *getTab() const;
 
+    // Counts a message which arrived while the page was hidden on the tab. Splits showing the
+    // same channel all report it, it's only counted once.
+    void addUnreadMessage(const messages::SharedMessage &message);
+
     void addChat(bool openChannelNameDialog = false);
 
     static bool isDraggingSplit;
@@ -79,6 +85,9 @@ private:
     std::vector<ChatWidget *> chatWidgets;
     std::vector<DropRegion> dropRegions;
 
+    // the splits report a message right after each other, so only the last few are remembered
+    std::deque<messages::SharedMessage> recentUnreadMessages;
+
     NotebookPageDropPreview dropPreview;
 
     void setPreviewRect(QPoint mousePos);
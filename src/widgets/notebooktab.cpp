@@ -32,10 +32,17 @@ NotebookTab::~NotebookTab()
 
 void NotebookTab::calcSize()
 {
+    int width = fontMetrics().width(_title) + 8;
+
+    // room for the largest count, so the tabs don't move for every unread message
+    if (_unreadCount > 0) {
+        width += fontMetrics().width(" 99+");
+    }
+
     if (SettingsManager::getInstance().hideTabX.get()) {
-        resize(fontMetrics().width(_title) + 8, 24);
+        resize(width, 24);
     } else {
-        resize(fontMetrics().width(_title) + 8 + 24, 24);
+        resize(width + 24, 24);
     }
 
     if (parent() != nullptr) {
@@ -75,6 +82,33 @@ void NotebookTab::setHighlightStyle(HighlightStyle style)
     update();
 }
 
+int NotebookTab::getUnreadCount() const
+{
+    return _unreadCount;
+}
+
+void NotebookTab::setUnreadCount(int count)
+{
+    bool sizeChanged = (_unreadCount > 0) != (count > 0);
+
+    _unreadCount = count;
+
+    if (sizeChanged) {
+        this->calcSize();
+    }
+
+    update();
+}
+
+QString NotebookTab::getUnreadText() const
+{
+    if (_unreadCount == 0) {
+        return QString();
+    }
+
+    return _unreadCount > 99 ? " 99+" : " " + QString::number(_unreadCount);
+}
+
 QRect NotebookTab::getDesiredRect() const
 {
     return QRect(_posAnimationDesired, size());
@@ -135,7 +169,7 @@ void NotebookTab::paintEvent(QPaintEvent *)
 
     QRect rect(0, 0, width() - (SettingsManager::getInstance().hideTabX.get() ? 0 : 16), height());
 
-    painter.drawText(rect, _title, QTextOption(Qt::AlignCenter));
+    painter.drawText(rect, _title + this->getUnreadText(), QTextOption(Qt::AlignCenter));
 
     if (!SettingsManager::getInstance().hideTabX.get() && (_mouseOver || _selected)) {
         if (_mouseOverX) {
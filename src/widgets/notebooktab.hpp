@@ -39,6 +39,10 @@ public:
     HighlightStyle getHighlightStyle() const;
     void setHighlightStyle(HighlightStyle style);
 
+    // Messages received while the page was hidden, shown next to the title
+    int getUnreadCount() const;
+    void setUnreadCount(int count);
+
     void moveAnimated(QPoint pos, bool animated = true);
 
     QRect getDesiredRect() const;
@@ -75,6 +79,10 @@ private:
 
     HighlightStyle _highlightStyle = HighlightStyle::HighlightNone;
 
+    int _unreadCount = 0;
+
+    QString getUnreadText() const;
+
     QRect getXRect()
     {
         return QRect(this->width() - 20, 4, 16, 16);
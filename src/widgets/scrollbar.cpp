@@ -52,27 +52,48 @@ void ScrollBar::removeHighlightsWhere(std::function<bool(ScrollBarHighlight &)>
             auto oldCurrent = current;
 
             current = current->next;
-            last = current;
 
             delete oldCurrent;
+        } else {
+            last = current;
+            current = current->next;
         }
     }
 
     _mutex.unlock();
+
+    update();
 }
 
 void ScrollBar::addHighlight(ScrollBarHighlight *highlight)
 {
     _mutex.lock();
 
-    if (_highlights == nullptr) {
-        _highlights = highlight;
-    } else {
-        highlight->next = _highlights->next;
-        _highlights->next = highlight;
+    highlight->next = _highlights;
+    _highlights = highlight;
+
+    _mutex.unlock();
+
+    update();
+}
+
+void ScrollBar::clearHighlights()
+{
+    this->removeHighlightsWhere([](ScrollBarHighlight &) { return true; });
+}
+
+void ScrollBar::offsetHighlights(double delta)
+{
+    _mutex.lock();
+
+    for (auto highlight = _highlights; highlight != nullptr; highlight = highlight->next) {
+        highlight->setPosition(highlight->getPosition() + delta);
     }
 
     _mutex.unlock();
+
+    this->removeHighlightsWhere(
+        [](ScrollBarHighlight &highlight) { return highlight.getPosition() < 0; });
 }
 
 void ScrollBar::scrollToBottom()
@@ -204,13 +225,34 @@ void ScrollBar::paintEvent(QPaintEvent *)
 
     painter.fillRect(_thumbRect, QColor(0, 255, 255));
 
-    //    ScrollBarHighlight *highlight = highlights;
+    if (_maximum <= 0) {
+        return;
+    }
+
+    int trackHeight = height() - _buttonHeight - _buttonHeight;
+    int w = width();
 
     _mutex.lock();
 
-    //    do {
-    //        painter.fillRect();
-    //    } while ((highlight = highlight->next()) != nullptr);
+    for (auto highlight = _highlights; highlight != nullptr; highlight = highlight->next) {
+        QColor color = this->colorScheme.HighlightColors[highlight->getColorIndex()];
+        int y = _buttonHeight + (int)(highlight->getPosition() / _maximum * trackHeight);
+
+        switch (highlight->getStyle()) {
+            case ScrollBarHighlight::Left:
+                painter.fillRect(0, y, w / 2, 2, color);
+                break;
+            case ScrollBarHighlight::Right:
+                painter.fillRect(w / 2, y, w - w / 2, 2, color);
+                break;
+            case ScrollBarHighlight::SingleLine:
+                painter.fillRect(0, y, w, 1, color);
+                break;
+            default:
+                painter.fillRect(0, y, w, 2, color);
+                break;
+        }
+    }
 
     _mutex.unlock();
 }
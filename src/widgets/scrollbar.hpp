@@ -26,6 +26,11 @@ public:
 
     void removeHighlightsWhere(std::function<bool(ScrollBarHighlight &)> func);
     void addHighlight(ScrollBarHighlight *highlight);
+    void clearHighlights();
+
+    // Moves all highlights by delta, the ones ending up before the start are removed. Used when
+    // messages are removed from the start of the chat.
+    void offsetHighlights(double delta);
 
     Q_PROPERTY(qreal _desiredValue READ getDesiredValue WRITE setDesiredValue)
 
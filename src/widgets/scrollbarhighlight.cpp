@@ -9,7 +9,7 @@ ScrollBarHighlight::ScrollBarHighlight(double _position, int _colorIndex, Scroll
                                        Style _style, QString _tag)
     : colorScheme(parent->colorScheme)
     , position(_position)
-    , colorIndex(std::max(0, std::min(this->colorScheme.HighlightColorCount, _colorIndex)))
+    , colorIndex(std::max(0, std::min(this->colorScheme.HighlightColorCount - 1, _colorIndex)))
     , style(_style)
     , tag(_tag)
 {
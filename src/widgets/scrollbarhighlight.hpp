@@ -25,6 +25,11 @@ public:
         return this->position;
     }
 
+    void setPosition(double value)
+    {
+        this->position = value;
+    }
+
     int getColorIndex()
     {
         return this->colorIndex;
@@ -0,0 +1,97 @@
+#include "widgets/searchwindow.hpp"
+
+#include <algorithm>
+#include <functional>
+
+namespace chatterino {
+namespace widgets {
+
+SearchWindow::SearchWindow(ChannelManager &_channelManager)
+    : search(_channelManager)
+{
+    this->setWindowTitle("Search all channels");
+    this->resize(600, 400);
+
+    this->setLayout(&this->ui.vbox);
+
+    this->ui.searchInput.setPlaceholderText("Search");
+    this->ui.includeLogs.setText("Include logs");
+    this->ui.cancelButton.setText("Cancel");
+    this->ui.cancelButton.setEnabled(false);
+    this->ui.results.setWordWrap(true);
+
+    this->ui.hbox.addWidget(&this->ui.searchInput, 1);
+    this->ui.hbox.addWidget(&this->ui.includeLogs);
+    this->ui.hbox.addWidget(&this->ui.cancelButton);
+
+    this->ui.vbox.addLayout(&this->ui.hbox);
+    this->ui.vbox.addWidget(&this->ui.status);
+    this->ui.vbox.addWidget(&this->ui.results, 1);
+
+    QObject::connect(&this->ui.searchInput, &QLineEdit::returnPressed, this,
+                     &SearchWindow::startSearch);
+    QObject::connect(&this->ui.cancelButton, &QPushButton::clicked, this, [this] {
+        this->search.cancel();
+        this->updateStatus();
+    });
+
+    this->search.resultsFound.connect(
+        [this](const std::vector<GlobalSearchResult> &results) { this->addResults(results); });
+    this->search.finished.connect([this] { this->updateStatus(); });
+}
+
+void SearchWindow::showWindow(ChannelManager &channelManager)
+{
+    static SearchWindow *instance = new SearchWindow(channelManager);
+
+    instance->show();
+    instance->activateWindow();
+    instance->raise();
+    instance->ui.searchInput.setFocus();
+}
+
+void SearchWindow::startSearch()
+{
+    this->ui.results.clear();
+    this->resultTimes.clear();
+
+    this->search.start(this->ui.searchInput.text(), this->ui.includeLogs.isChecked());
+
+    this->updateStatus();
+}
+
+void SearchWindow::addResults(const std::vector<GlobalSearchResult> &results)
+{
+    for (const GlobalSearchResult &result : results) {
+        // keep the list sorted by time as results stream in
+        auto position = std::upper_bound(this->resultTimes.begin(), this->resultTimes.end(),
+                                         result.time, std::greater<QDateTime>());
+        int row = static_cast<int>(position - this->resultTimes.begin());
+
+        this->resultTimes.insert(position, result.time);
+
+        QString text = result.time.toString("yyyy-MM-dd HH:mm:ss") + " #" + result.channelName +
+                       " " + result.userName + ": " + result.text;
+
+        if (result.fromLog) {
+            text += " (log)";
+        }
+
+        this->ui.results.insertItem(row, text);
+    }
+
+    this->updateStatus();
+}
+
+void SearchWindow::updateStatus()
+{
+    bool running = this->search.isRunning();
+
+    this->ui.cancelButton.setEnabled(running);
+    this->ui.status.setText(QString("%1%2 results")
+                                .arg(running ? "Searching... " : "")
+                                .arg(this->resultTimes.size()));
+}
+
+}  // namespace widgets
+}  // namespace chatterino
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "globalsearch.hpp"
+
+#include <QCheckBox>
+#include <QHBoxLayout>
+#include <QLabel>
+#include <QLineEdit>
+#include <QListWidget>
+#include <QPushButton>
+#include <QVBoxLayout>
+#include <QWidget>
+
+#include <vector>
+
+namespace chatterino {
+
+class ChannelManager;
+
+namespace widgets {
+
+// Searches all open channels (and the logs) at once, newest results first
+class SearchWindow : public QWidget
+{
+public:
+    explicit SearchWindow(ChannelManager &_channelManager);
+
+    static void showWindow(ChannelManager &channelManager);
+
+private:
+    GlobalSearch search;
+
+    struct {
+        QVBoxLayout vbox;
+        QHBoxLayout hbox;
+        QLineEdit searchInput;
+        QCheckBox includeLogs;
+        QPushButton cancelButton;
+        QLabel status;
+        QListWidget results;
+    } ui;
+
+    // times of the rows in ui.results, newest first
+    std::vector<QDateTime> resultTimes;
+
+    void startSearch();
+    void addResults(const std::vector<GlobalSearchResult> &results);
+    void updateStatus();
+};
+
+}  // namespace widgets
+}  // namespace chatterino
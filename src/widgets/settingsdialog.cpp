@@ -278,6 +278,10 @@ void SettingsDialog::addTabs()
         form->addRow("", createCheckbox("Hide input box if empty", settings.hideEmptyInput));
         form->addRow("", createCheckbox("Show last read message indicator",
                                         settings.showLastMessageIndicator));
+        form->addRow("", createCheckbox("Lower the frame rate of very fast chats",
+                                        settings.enableFastChatThrottling));
+        form->addRow("Logs:", createCheckbox("Log the messages of all channels",
+                                             settings.enableLogging));
 
         //        auto v = new QVBoxLayout();
         //        v->addWidget(new QLabel("Mouse scroll speed"));
@@ -325,7 +329,12 @@ void SettingsDialog::addTabs()
 
     // Ignored Messages
     vbox = new QVBoxLayout();
-    vbox->addStretch(1);
+
+    vbox->addWidget(new QLabel("Ignore messages containing any of these phrases (one per line):"));
+    vbox->addWidget(createTextEdit(settings.ignoredPhrases));
+    vbox->addWidget(new QLabel("Ignore messages containing any of these emotes (one per line):"));
+    vbox->addWidget(createTextEdit(settings.ignoredEmotes));
+
     addTab(vbox, "Ignored Messages", ":/images/Filter_16x.png");
 
     // Links
@@ -340,7 +349,16 @@ void SettingsDialog::addTabs()
 
     // Highlighting
     vbox = new QVBoxLayout();
-    vbox->addStretch(1);
+
+    vbox->addWidget(createCheckbox("Enable highlights", settings.enableHighlights));
+    vbox->addWidget(
+        createCheckbox("Flash taskbar on highlights", settings.enableHighlightTaskbar));
+    vbox->addWidget(new QLabel("Highlight messages containing your name or any of these phrases "
+                               "(one per line):"));
+    vbox->addWidget(createTextEdit(settings.highlightPhrases));
+    vbox->addWidget(new QLabel("Highlight messages matching any of these regexes (one per line):"));
+    vbox->addWidget(createTextEdit(settings.highlightRegexes));
+
     addTab(vbox, "Highlighting", ":/images/format_Bold_16xLG.png");
 
     // Whispers
@@ -426,6 +444,17 @@ QCheckBox *SettingsDialog::createCheckbox(const QString &title,
     return checkbox;
 }
 
+QPlainTextEdit *SettingsDialog::createTextEdit(Setting<QString> &setting)
+{
+    auto textEdit = new QPlainTextEdit(setting.get());
+
+    QObject::connect(textEdit, &QPlainTextEdit::textChanged, this, [&setting, textEdit] {
+        setting.set(textEdit->toPlainText());  //
+    });
+
+    return textEdit;
+}
+
 QHBoxLayout *SettingsDialog::createCombobox(
     const QString &title, pajlada::Settings::Setting<int> &setting, QStringList items,
     std::function<void(QString, pajlada::Settings::Setting<int> &)> cb)
@@ -11,6 +11,7 @@
 #include <QHBoxLayout>
 #include <QListView>
 #include <QMainWindow>
+#include <QPlainTextEdit>
 #include <QPushButton>
 #include <QStackedLayout>
 #include <QVBoxLayout>
@@ -54,6 +55,7 @@ private:
     /// Widget creation helpers
     QCheckBox *createCheckbox(const QString &title, Setting<bool> &setting);
     QCheckBox *createCheckbox(const QString &title, pajlada::Settings::Setting<bool> &setting);
+    QPlainTextEdit *createTextEdit(Setting<QString> &setting);
     QHBoxLayout *createCombobox(const QString &title, pajlada::Settings::Setting<int> &setting,
                                 QStringList items,
                                 std::function<void(QString, pajlada::Settings::Setting<int> &)> cb);
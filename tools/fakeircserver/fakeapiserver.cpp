@@ -0,0 +1,197 @@
+#include "fakeapiserver.hpp"
+
+#include <QDebug>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QUrl>
+#include <QUrlQuery>
+
+#include <algorithm>
+
+namespace fakeircserver {
+
+namespace {
+
+const int defaultPageSize = 25;
+
+QByteArray statusText(int status)
+{
+    switch (status) {
+        case 200:
+            return "OK";
+        case 204:
+            return "No Content";
+        case 404:
+            return "Not Found";
+        case 503:
+            return "Service Unavailable";
+        default:
+            return "Bad Request";
+    }
+}
+
+}  // namespace
+
+FakeApiServer::FakeApiServer(int blockedUserCount, double _failureRate, QObject *parent)
+    : QObject(parent)
+    , failureRate(_failureRate)
+    , random(std::random_device()())
+{
+    for (int i = 0; i < blockedUserCount; i++) {
+        this->blockedUsers.append("blockeduser" + QString::number(i));
+    }
+
+    QObject::connect(&this->server, &QTcpServer::newConnection, this,
+                     &FakeApiServer::onNewConnection);
+}
+
+bool FakeApiServer::listen(quint16 port)
+{
+    if (!this->server.listen(QHostAddress::Any, port)) {
+        qWarning() << "[FakeApiServer] Unable to listen on port" << port << ":"
+                   << this->server.errorString();
+        return false;
+    }
+
+    qDebug() << "[FakeApiServer] Listening on port" << this->server.serverPort() << "with"
+             << this->blockedUsers.size() << "blocked users";
+
+    return true;
+}
+
+void FakeApiServer::onNewConnection()
+{
+    while (QTcpSocket *socket = this->server.nextPendingConnection()) {
+        QObject::connect(socket, &QTcpSocket::readyRead, this,
+                         [this, socket] { this->onReadyRead(socket); });
+        QObject::connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+    }
+}
+
+void FakeApiServer::onReadyRead(QTcpSocket *socket)
+{
+    // requests without a body are all we need, wait until the headers are complete
+    QByteArray data = socket->peek(socket->bytesAvailable());
+    int headerEnd = data.indexOf("\r\n\r\n");
+
+    if (headerEnd == -1) {
+        return;
+    }
+
+    socket->read(headerEnd + 4);
+
+    QList<QByteArray> lines = data.left(headerEnd).split('\n');
+    QList<QByteArray> requestLine = lines.value(0).trimmed().split(' ');
+
+    if (requestLine.size() < 2) {
+        this->sendResponse(socket, 400);
+        return;
+    }
+
+    QByteArray host = "127.0.0.1:" + QByteArray::number(this->server.serverPort());
+
+    for (const QByteArray &line : lines) {
+        if (line.toLower().startsWith("host:")) {
+            host = line.mid(5).trimmed();
+        }
+    }
+
+    this->handleRequest(socket, requestLine[0], requestLine[1], host);
+}
+
+void FakeApiServer::handleRequest(QTcpSocket *socket, const QByteArray &method,
+                                  const QByteArray &target, const QByteArray &host)
+{
+    QUrl url(QString::fromUtf8(target));
+    QStringList path = url.path().split('/', QString::SkipEmptyParts);
+
+    // users/<user>/blocks[/<target user>]
+    if (path.size() < 3 || path[0] != "users" || path[2] != "blocks") {
+        this->sendResponse(socket, 404);
+        return;
+    }
+
+    if (method == "GET" && path.size() == 3) {
+        QUrlQuery query(url);
+
+        int limit = query.queryItemValue("limit").toInt();
+        int offset = query.queryItemValue("offset").toInt();
+
+        if (limit <= 0) {
+            limit = defaultPageSize;
+        }
+
+        QJsonArray blocks;
+
+        for (int i = offset; i < std::min(offset + limit, this->blockedUsers.size()); i++) {
+            QJsonObject user;
+            user.insert("name", this->blockedUsers[i]);
+            user.insert("display_name", this->blockedUsers[i]);
+
+            QJsonObject block;
+            block.insert("user", user);
+
+            blocks.append(block);
+        }
+
+        QJsonObject links;
+
+        if (offset + limit < this->blockedUsers.size()) {
+            links.insert("next", QString("http://%1/users/%2/blocks?limit=%3&offset=%4")
+                                      .arg(QString::fromUtf8(host), path[1])
+                                      .arg(limit)
+                                      .arg(offset + limit));
+        }
+
+        QJsonObject root;
+        root.insert("_total", this->blockedUsers.size());
+        root.insert("_links", links);
+        root.insert("blocks", blocks);
+
+        this->sendResponse(socket, 200, QJsonDocument(root).toJson(QJsonDocument::Compact));
+        return;
+    }
+
+    if (path.size() != 4 || (method != "PUT" && method != "DELETE")) {
+        this->sendResponse(socket, 400);
+        return;
+    }
+
+    if (std::uniform_real_distribution<double>(0.0, 1.0)(this->random) < this->failureRate) {
+        qDebug() << "[FakeApiServer] Failing" << method << path[3];
+        this->sendResponse(socket, 503);
+        return;
+    }
+
+    const QString &userName = path[3];
+
+    if (method == "PUT") {
+        if (!this->blockedUsers.contains(userName)) {
+            this->blockedUsers.append(userName);
+        }
+
+        QJsonObject user;
+        user.insert("name", userName);
+
+        QJsonObject root;
+        root.insert("user", user);
+
+        this->sendResponse(socket, 200, QJsonDocument(root).toJson(QJsonDocument::Compact));
+    } else {
+        this->sendResponse(socket, this->blockedUsers.removeAll(userName) > 0 ? 204 : 404);
+    }
+}
+
+void FakeApiServer::sendResponse(QTcpSocket *socket, int status, const QByteArray &body)
+{
+    QByteArray response = "HTTP/1.1 " + QByteArray::number(status) + " " + statusText(status) +
+                          "\r\nContent-Type: application/json\r\nContent-Length: " +
+                          QByteArray::number(body.size()) + "\r\nConnection: close\r\n\r\n" +
+                          body;
+
+    socket->write(response);
+    socket->disconnectFromHost();
+}
+
+}  // namespace fakeircserver
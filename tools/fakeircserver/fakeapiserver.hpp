@@ -0,0 +1,43 @@
+#pragma once
+
+#include <QByteArray>
+#include <QObject>
+#include <QSet>
+#include <QStringList>
+#include <QTcpServer>
+#include <QTcpSocket>
+
+#include <random>
+
+namespace fakeircserver {
+
+// FakeApiServer is a stand-in for the parts of the Twitch API chatterino talks to: the paginated
+// block list, blocking and unblocking users. Point chatterino at it by setting
+// /connection/twitch/apiBaseUrl to http://127.0.0.1:<port>.
+class FakeApiServer : public QObject
+{
+    Q_OBJECT
+
+public:
+    // failureRate is the chance for a block/unblock request to fail with a 503, to test rollbacks
+    FakeApiServer(int blockedUserCount, double _failureRate, QObject *parent = nullptr);
+
+    bool listen(quint16 port);
+
+private:
+    QTcpServer server;
+
+    QStringList blockedUsers;
+    double failureRate;
+
+    std::mt19937 random;
+
+    void onNewConnection();
+    void onReadyRead(QTcpSocket *socket);
+
+    void handleRequest(QTcpSocket *socket, const QByteArray &method, const QByteArray &target,
+                       const QByteArray &host);
+    void sendResponse(QTcpSocket *socket, int status, const QByteArray &body = QByteArray());
+};
+
+}  // namespace fakeircserver
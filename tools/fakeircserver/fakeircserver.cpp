@@ -0,0 +1,285 @@
+#include "fakeircserver.hpp"
+
+#include <QDateTime>
+#include <QDebug>
+
+#include <algorithm>
+#include <cmath>
+
+#define TICK_INTERVAL_MS 10
+
+namespace fakeircserver {
+
+FakeIrcServer::FakeIrcServer(const LoadOptions &loadOptions, QObject *parent)
+    : QObject(parent)
+    , generator(loadOptions)
+{
+    QObject::connect(&this->server, &QTcpServer::newConnection, this,
+                     &FakeIrcServer::onNewConnection);
+
+    QObject::connect(&this->tickTimer, &QTimer::timeout, this, &FakeIrcServer::tick);
+    this->tickTimer.setTimerType(Qt::PreciseTimer);
+    this->tickTimer.start(TICK_INTERVAL_MS);
+    this->tickElapsed.start();
+
+    QObject::connect(&this->statisticsTimer, &QTimer::timeout, [this] {
+        qDebug() << "[FakeIrcServer]" << this->clients.size() << "clients,"
+                 << this->messageBudgets.size() << "channels," << this->linesSent
+                 << "lines sent in the last 10 seconds";
+
+        this->linesSent = 0;
+    });
+    this->statisticsTimer.start(10000);
+}
+
+bool FakeIrcServer::listen(quint16 port)
+{
+    if (!this->server.listen(QHostAddress::Any, port)) {
+        qDebug() << "[FakeIrcServer] Unable to listen on port" << port << ":"
+                 << this->server.errorString();
+        return false;
+    }
+
+    qDebug() << "[FakeIrcServer] Listening on port" << port;
+
+    return true;
+}
+
+void FakeIrcServer::onNewConnection()
+{
+    while (QTcpSocket *socket = this->server.nextPendingConnection()) {
+        auto client = new Client;
+        client->socket = socket;
+
+        this->clients.emplace_back(client);
+
+        QObject::connect(socket, &QTcpSocket::readyRead, this,
+                         [this, client] { this->onReadyRead(client); });
+        QObject::connect(socket, &QTcpSocket::disconnected, this,
+                         [this, client] { this->onDisconnected(client); });
+    }
+}
+
+void FakeIrcServer::onReadyRead(Client *client)
+{
+    client->readBuffer += client->socket->readAll();
+
+    int index;
+
+    while ((index = client->readBuffer.indexOf('\n')) != -1) {
+        QByteArray line = client->readBuffer.left(index);
+        client->readBuffer.remove(0, index + 1);
+
+        if (line.endsWith('\r')) {
+            line.chop(1);
+        }
+
+        if (!line.isEmpty()) {
+            this->handleLine(client, line);
+        }
+    }
+}
+
+void FakeIrcServer::onDisconnected(Client *client)
+{
+    QObject::disconnect(client->socket, nullptr, this, nullptr);
+    client->socket->deleteLater();
+
+    auto it = std::find_if(this->clients.begin(), this->clients.end(),
+                           [client](const std::unique_ptr<Client> &c) { return c.get() == client; });
+
+    if (it != this->clients.end()) {
+        this->clients.erase(it);
+    }
+}
+
+void FakeIrcServer::handleLine(Client *client, const QByteArray &line)
+{
+    // Split off the trailing parameter
+    QByteArray trailing;
+    QByteArray head = line;
+
+    int trailingIndex = line.indexOf(" :");
+    if (trailingIndex != -1) {
+        trailing = line.mid(trailingIndex + 2);
+        head = line.left(trailingIndex);
+    }
+
+    QList<QByteArray> params = head.split(' ');
+    QByteArray command = params.takeFirst().toUpper();
+
+    if (command == "CAP") {
+        // CAP REQ :twitch.tv/tags
+        if (params.value(0).toUpper() == "REQ") {
+            for (const QByteArray &capability : trailing.split(' ')) {
+                if (capability == "twitch.tv/tags") {
+                    client->tags = true;
+                } else if (capability == "twitch.tv/commands") {
+                    client->commands = true;
+                } else if (capability == "twitch.tv/membership") {
+                    client->membership = true;
+                }
+            }
+
+            this->send(client, ":tmi.twitch.tv CAP * ACK :" + trailing);
+        } else if (params.value(0).toUpper() == "LS") {
+            this->send(client,
+                       ":tmi.twitch.tv CAP * LS :twitch.tv/tags twitch.tv/commands "
+                       "twitch.tv/membership");
+        }
+    } else if (command == "PASS" || command == "USER") {
+        // Any password is fine
+    } else if (command == "NICK") {
+        client->nickName = QString::fromUtf8(params.value(0, trailing));
+
+        QByteArray nick = client->nickName.toUtf8();
+
+        this->send(client, ":tmi.twitch.tv 001 " + nick + " :Welcome, GLHF!");
+        this->send(client, ":tmi.twitch.tv 002 " + nick + " :Your host is tmi.twitch.tv");
+        this->send(client, ":tmi.twitch.tv 003 " + nick + " :This server is rather new");
+        this->send(client, ":tmi.twitch.tv 004 " + nick + " :-");
+        this->send(client, ":tmi.twitch.tv 375 " + nick + " :-");
+        this->send(client, ":tmi.twitch.tv 372 " + nick + " :You are in a great big fake chat.");
+        this->send(client, ":tmi.twitch.tv 376 " + nick + " :>");
+    } else if (command == "PING") {
+        this->send(client, ":tmi.twitch.tv PONG tmi.twitch.tv :" +
+                               (trailing.isEmpty() ? params.value(0) : trailing));
+    } else if (command == "JOIN") {
+        // JOIN #a,#b,#c
+        for (const QByteArray &channel : params.value(0, trailing).split(',')) {
+            if (channel.startsWith('#')) {
+                this->handleJoin(client, QString::fromUtf8(channel.mid(1)).toLower());
+            }
+        }
+    } else if (command == "PART") {
+        for (const QByteArray &channel : params.value(0, trailing).split(',')) {
+            if (channel.startsWith('#')) {
+                this->handlePart(client, QString::fromUtf8(channel.mid(1)).toLower());
+            }
+        }
+    } else if (command == "PRIVMSG") {
+        QByteArray target = params.value(0);
+
+        if (target.startsWith('#')) {
+            this->handlePrivateMessage(client, QString::fromUtf8(target.mid(1)).toLower(),
+                                       QString::fromUtf8(trailing));
+        }
+    } else {
+        this->send(client, ":tmi.twitch.tv 421 " + client->nickName.toUtf8() + " " + command +
+                               " :Unknown command");
+    }
+}
+
+void FakeIrcServer::handleJoin(Client *client, const QString &channelName)
+{
+    client->channels.insert(channelName);
+
+    if (!this->messageBudgets.contains(channelName)) {
+        this->messageBudgets.insert(channelName, 0.0);
+    }
+
+    QByteArray nick = client->nickName.toUtf8();
+    QByteArray channel = "#" + channelName.toUtf8();
+
+    this->send(client, ":" + nick + "!" + nick + "@" + nick + ".tmi.twitch.tv JOIN " + channel);
+
+    if (client->membership) {
+        this->send(client, ":" + nick + ".tmi.twitch.tv 353 " + nick + " = " + channel + " :" +
+                               nick);
+        this->send(client,
+                   ":" + nick + ".tmi.twitch.tv 366 " + nick + " " + channel + " :End of /NAMES list");
+    }
+
+    if (client->tags && client->commands) {
+        this->send(client, "@badges=;color=;display-name=" + nick +
+                               ";emote-sets=0;mod=0;subscriber=0;user-type= :tmi.twitch.tv "
+                               "USERSTATE " +
+                               channel);
+        this->send(client, "@broadcaster-lang=;emote-only=0;followers-only=-1;r9k=0;room-id=" +
+                               LoadGenerator::roomIdForChannel(channelName).toUtf8() +
+                               ";slow=0;subs-only=0 :tmi.twitch.tv ROOMSTATE " + channel);
+    }
+}
+
+void FakeIrcServer::handlePart(Client *client, const QString &channelName)
+{
+    client->channels.remove(channelName);
+
+    QByteArray nick = client->nickName.toUtf8();
+
+    this->send(client, ":" + nick + "!" + nick + "@" + nick + ".tmi.twitch.tv PART #" +
+                           channelName.toUtf8());
+
+    // Stop generating messages for channels nobody is in anymore
+    for (const auto &c : this->clients) {
+        if (c->channels.contains(channelName)) {
+            return;
+        }
+    }
+
+    this->messageBudgets.remove(channelName);
+}
+
+void FakeIrcServer::handlePrivateMessage(Client *client, const QString &channelName,
+                                         const QString &text)
+{
+    QByteArray nick = client->nickName.toUtf8();
+    QByteArray channel = "#" + channelName.toUtf8();
+
+    if (client->tags && client->commands) {
+        this->send(client, "@badges=;color=;display-name=" + nick +
+                               ";emote-sets=0;mod=0;subscriber=0;user-type= :tmi.twitch.tv "
+                               "USERSTATE " +
+                               channel);
+    }
+
+    QByteArray line = "@badges=;color=#FF0000;display-name=" + nick + ";emotes=;id=echo-" +
+                      QByteArray::number(QDateTime::currentMSecsSinceEpoch()) + ";mod=0;room-id=" +
+                      LoadGenerator::roomIdForChannel(channelName).toUtf8() +
+                      ";subscriber=0;tmi-sent-ts=" +
+                      QByteArray::number(QDateTime::currentMSecsSinceEpoch()) +
+                      ";turbo=0;user-type= :" + nick + "!" + nick + "@" + nick +
+                      ".tmi.twitch.tv PRIVMSG " + channel + " :" + text.toUtf8();
+
+    // Like twitch, the sender doesn't get its own message echoed back
+    this->broadcast(channelName, line + "\r\n", client);
+}
+
+void FakeIrcServer::tick()
+{
+    double elapsedSeconds = this->tickElapsed.restart() / 1000.0;
+    double rate = this->generator.getOptions().messagesPerSecond;
+
+    for (auto it = this->messageBudgets.begin(); it != this->messageBudgets.end(); ++it) {
+        it.value() += rate * elapsedSeconds;
+
+        double wholeMessages = std::floor(it.value());
+        it.value() -= wholeMessages;
+
+        for (int i = 0; i < static_cast<int>(wholeMessages); i++) {
+            this->broadcast(it.key(), this->generator.generateEvent(it.key()));
+        }
+    }
+}
+
+void FakeIrcServer::send(Client *client, const QByteArray &line)
+{
+    client->socket->write(line + "\r\n");
+
+    this->linesSent++;
+}
+
+void FakeIrcServer::broadcast(const QString &channelName, const QByteArray &line, Client *except)
+{
+    for (const auto &client : this->clients) {
+        if (client.get() == except || !client->channels.contains(channelName)) {
+            continue;
+        }
+
+        client->socket->write(line);
+
+        this->linesSent++;
+    }
+}
+
+}  // namespace fakeircserver
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "loadgenerator.hpp"
+
+#include <QElapsedTimer>
+#include <QMap>
+#include <QObject>
+#include <QSet>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QTimer>
+
+#include <memory>
+#include <vector>
+
+namespace fakeircserver {
+
+// FakeIrcServer speaks just enough of the Twitch IRC dialect for chatterino to connect, join
+// channels and receive messages. Every joined channel is fed with synthetic chat generated by the
+// LoadGenerator.
+class FakeIrcServer : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit FakeIrcServer(const LoadOptions &loadOptions, QObject *parent = nullptr);
+
+    bool listen(quint16 port);
+
+private:
+    struct Client {
+        QTcpSocket *socket = nullptr;
+        QByteArray readBuffer;
+
+        QString nickName = "justinfan";
+        QSet<QString> channels;
+
+        bool tags = false;
+        bool commands = false;
+        bool membership = false;
+    };
+
+    QTcpServer server;
+    std::vector<std::unique_ptr<Client>> clients;
+
+    LoadGenerator generator;
+
+    QTimer tickTimer;
+    QElapsedTimer tickElapsed;
+
+    // channel name => messages we owe to the channel since the last tick
+    QMap<QString, double> messageBudgets;
+
+    unsigned long long linesSent = 0;
+    QTimer statisticsTimer;
+
+    void onNewConnection();
+    void onReadyRead(Client *client);
+    void onDisconnected(Client *client);
+
+    void handleLine(Client *client, const QByteArray &line);
+    void handleJoin(Client *client, const QString &channelName);
+    void handlePart(Client *client, const QString &channelName);
+    void handlePrivateMessage(Client *client, const QString &channelName, const QString &text);
+
+    void tick();
+
+    void send(Client *client, const QByteArray &line);
+    void broadcast(const QString &channelName, const QByteArray &line, Client *except = nullptr);
+};
+
+}  // namespace fakeircserver
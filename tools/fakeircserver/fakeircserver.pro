@@ -0,0 +1,26 @@
+#-------------------------------------------------
+#
+# Fake Twitch IRC server used for soak and load testing chatterino
+#
+#-------------------------------------------------
+
+QT      += core network
+QT      -= gui
+CONFIG  += c++14 console
+CONFIG  -= app_bundle
+
+TARGET   = fakeircserver
+TEMPLATE = app
+
+DEFINES += QT_DEPRECATED_WARNINGS
+
+SOURCES += \
+    main.cpp \
+    fakeircserver.cpp \
+    fakeapiserver.cpp \
+    loadgenerator.cpp
+
+HEADERS  += \
+    fakeircserver.hpp \
+    fakeapiserver.hpp \
+    loadgenerator.hpp
@@ -0,0 +1,320 @@
+#include "loadgenerator.hpp"
+
+#include <QDateTime>
+#include <QMap>
+#include <QVector>
+
+namespace fakeircserver {
+
+namespace {
+
+struct FakeEmote {
+    int id;
+    const char *code;
+};
+
+// A couple of twitch global emotes, so the client resolves real images
+const FakeEmote twitchEmotes[] = {
+    {25, "Kappa"},        {88, "PogChamp"},  {354, "4Head"},    {41, "Kreygasm"},
+    {36, "PJSalt"},       {1902, "Keepo"},   {86, "BibleThump"}, {425618, "LUL"},
+    {245, "ResidentSleeper"}, {28087, "WutFace"},
+};
+
+const char *emojis[] = {
+    "\xF0\x9F\x98\x82",  // face with tears of joy
+    "\xF0\x9F\x94\xA5",  // fire
+    "\xF0\x9F\x91\x80",  // eyes
+    "\xF0\x9F\x98\x8E",  // smiling face with sunglasses
+    "\xF0\x9F\x91\x8C",  // ok hand
+    "\xF0\x9F\x98\xAD",  // loudly crying face
+};
+
+const char *words[] = {
+    "hello", "chat",  "what",  "is",   "this", "game", "lol",    "nice", "play", "clip",
+    "that",  "streamer", "when", "go",  "gg",   "wp",   "no",     "yes",  "maybe", "the",
+    "a",     "really", "insane", "how", "did",  "he",   "do",     "it",   "again", "omg",
+    "https://www.twitch.tv", "poggers", "true", "false", "first", "last", "time", "ever",
+};
+
+const char *userNoticeTypes[] = {"sub", "resub", "subgift", "raid", "ritual"};
+
+// messages a copypasta is picked from
+const size_t recentContentCount = 8;
+
+template <typename T, std::size_t N>
+constexpr std::size_t arraySize(T (&)[N])
+{
+    return N;
+}
+
+// IRCv3 tag value escaping
+QString escapeTagValue(const QString &value)
+{
+    QString escaped;
+    escaped.reserve(value.size());
+
+    for (const QChar &c : value) {
+        if (c == ';') {
+            escaped += "\\:";
+        } else if (c == ' ') {
+            escaped += "\\s";
+        } else if (c == '\\') {
+            escaped += "\\\\";
+        } else if (c == '\r') {
+            escaped += "\\r";
+        } else if (c == '\n') {
+            escaped += "\\n";
+        } else {
+            escaped += c;
+        }
+    }
+
+    return escaped;
+}
+
+}  // namespace
+
+LoadGenerator::LoadGenerator(const LoadOptions &_options)
+    : options(_options)
+    , random(std::random_device()())
+    , chance(0.0, 1.0)
+{
+}
+
+const LoadOptions &LoadGenerator::getOptions() const
+{
+    return this->options;
+}
+
+QByteArray LoadGenerator::generateEvent(const QString &channelName)
+{
+    double value = this->chance(this->random);
+
+    if (value < this->options.clearChatRatio) {
+        return this->generateClearChat(channelName);
+    }
+
+    if (value < this->options.clearChatRatio + this->options.userNoticeRatio) {
+        return this->generateUserNotice(channelName);
+    }
+
+    return this->generatePrivateMessage(channelName);
+}
+
+QByteArray LoadGenerator::generatePrivateMessage(const QString &channelName)
+{
+    QString userName = this->randomUserName();
+    QString emotesTag;
+    int bits = 0;
+    QString content;
+
+    if (!this->recentContents.empty() && this->roll(this->options.copypastaRatio)) {
+        const Content &recent =
+            this->recentContents[this->randomInt(0, this->recentContents.size() - 1)];
+
+        content = recent.text;
+        emotesTag = recent.emotesTag;
+        bits = recent.bits;
+    } else {
+        content = this->generateContent(emotesTag, bits);
+
+        this->recentContents.push_front({content, emotesTag, bits});
+
+        if (this->recentContents.size() > recentContentCount) {
+            this->recentContents.pop_back();
+        }
+    }
+
+    QByteArray line = this->buildUserTags(channelName, userName);
+    line += ";emotes=" + emotesTag.toUtf8();
+
+    if (bits > 0) {
+        line += ";bits=" + QByteArray::number(bits);
+    }
+
+    line += " :" + userName.toUtf8() + "!" + userName.toUtf8() + "@" + userName.toUtf8() +
+            ".tmi.twitch.tv PRIVMSG #" + channelName.toUtf8() + " :" + content.toUtf8() + "\r\n";
+
+    return line;
+}
+
+QByteArray LoadGenerator::generateClearChat(const QString &channelName)
+{
+    QByteArray line = "@room-id=" + roomIdForChannel(channelName).toUtf8() +
+                      ";tmi-sent-ts=" +
+                      QByteArray::number(QDateTime::currentMSecsSinceEpoch());
+
+    // Every 20th clearchat clears the whole channel, the rest time out a single chatter
+    if (this->roll(0.05)) {
+        line += " :tmi.twitch.tv CLEARCHAT #" + channelName.toUtf8() + "\r\n";
+
+        return line;
+    }
+
+    QString userName = this->randomUserName();
+
+    if (this->roll(0.2)) {
+        line += ";ban-reason=";
+    } else {
+        line += ";ban-duration=" + QByteArray::number(this->randomInt(1, 600)) + ";ban-reason=";
+    }
+
+    line += " :tmi.twitch.tv CLEARCHAT #" + channelName.toUtf8() + " :" + userName.toUtf8() +
+            "\r\n";
+
+    return line;
+}
+
+QByteArray LoadGenerator::generateUserNotice(const QString &channelName)
+{
+    QString userName = this->randomUserName();
+    QString msgId = userNoticeTypes[this->randomInt(0, arraySize(userNoticeTypes) - 1)];
+    int months = this->randomInt(1, 48);
+
+    QString systemMessage = userName + " just subscribed for " + QString::number(months) +
+                            " months in a row!";
+
+    QByteArray line = this->buildUserTags(channelName, userName);
+    line += ";login=" + userName.toUtf8();
+    line += ";msg-id=" + msgId.toUtf8();
+    line += ";msg-param-months=" + QByteArray::number(months);
+    line += ";msg-param-sub-plan=1000";
+    line += ";system-msg=" + escapeTagValue(systemMessage).toUtf8();
+    line += " :tmi.twitch.tv USERNOTICE #" + channelName.toUtf8();
+
+    // resubs are allowed to carry a message
+    if (msgId == "resub" && this->roll(0.5)) {
+        QString emotesTag;
+        int bits = 0;
+
+        line += " :" + this->generateContent(emotesTag, bits).toUtf8();
+    }
+
+    line += "\r\n";
+
+    return line;
+}
+
+QString LoadGenerator::roomIdForChannel(const QString &channelName)
+{
+    return QString::number(qHash(channelName) % 100000000 + 1000);
+}
+
+bool LoadGenerator::roll(double probability)
+{
+    return this->chance(this->random) < probability;
+}
+
+int LoadGenerator::randomInt(int min, int max)
+{
+    return std::uniform_int_distribution<int>(min, max)(this->random);
+}
+
+QString LoadGenerator::randomUserName()
+{
+    return "fakeuser" + QString::number(this->randomInt(0, std::max(0, options.userCount - 1)));
+}
+
+QString LoadGenerator::randomColor()
+{
+    return QString("#%1").arg(this->randomInt(0, 0xffffff), 6, 16, QChar('0')).toUpper();
+}
+
+QString LoadGenerator::randomBadges()
+{
+    QStringList badges;
+
+    if (this->roll(0.05)) {
+        badges.append("moderator/1");
+    }
+
+    if (this->roll(0.3)) {
+        badges.append("subscriber/" + QString::number(this->randomInt(0, 24)));
+    }
+
+    if (this->roll(0.05)) {
+        badges.append("premium/1");
+    }
+
+    if (this->roll(0.05)) {
+        badges.append("bits/" + QString::number(this->randomInt(1, 5) * 100));
+    }
+
+    return badges.join(',');
+}
+
+QString LoadGenerator::generateContent(QString &emotesTag, int &bits)
+{
+    int targetLength = this->roll(this->options.longMessageRatio) ? 450 : this->randomInt(3, 80);
+
+    QStringList parts;
+
+    // emote id => occurences in "start-end" format
+    QMap<int, QStringList> emoteOccurences;
+
+    // twitch counts emote positions in code points
+    int position = 0;
+    int length = 0;
+
+    if (this->roll(this->options.bitsRatio)) {
+        bits = this->randomInt(1, 100) * (this->roll(0.1) ? 100 : 1);
+
+        QString cheer = "cheer" + QString::number(bits);
+
+        parts.append(cheer);
+        position += cheer.size() + 1;
+        length += cheer.size() + 1;
+    }
+
+    while (length < targetLength) {
+        QString word;
+        double value = this->chance(this->random);
+
+        if (value < this->options.emoteDensity) {
+            const FakeEmote &emote = twitchEmotes[this->randomInt(0, arraySize(twitchEmotes) - 1)];
+
+            word = emote.code;
+            emoteOccurences[emote.id].append(QString::number(position) + "-" +
+                                             QString::number(position + word.size() - 1));
+        } else if (value < this->options.emoteDensity + this->options.emojiDensity) {
+            word = QString::fromUtf8(emojis[this->randomInt(0, arraySize(emojis) - 1)]);
+        } else {
+            word = words[this->randomInt(0, arraySize(words) - 1)];
+        }
+
+        parts.append(word);
+
+        position += word.toUcs4().size() + 1;
+        length += word.size() + 1;
+    }
+
+    QStringList emotes;
+
+    for (auto it = emoteOccurences.begin(); it != emoteOccurences.end(); ++it) {
+        emotes.append(QString::number(it.key()) + ":" + it.value().join(','));
+    }
+
+    emotesTag = emotes.join('/');
+
+    return parts.join(' ');
+}
+
+QByteArray LoadGenerator::buildUserTags(const QString &channelName, const QString &userName)
+{
+    QByteArray tags = "@badges=" + this->randomBadges().toUtf8();
+
+    tags += ";color=" + this->randomColor().toUtf8();
+    tags += ";display-name=" + userName.toUtf8();
+    tags += ";id=fake-" + QByteArray::number(this->nextMessageId++);
+    tags += ";mod=0";
+    tags += ";room-id=" + roomIdForChannel(channelName).toUtf8();
+    tags += ";subscriber=0";
+    tags += ";tmi-sent-ts=" + QByteArray::number(QDateTime::currentMSecsSinceEpoch());
+    tags += ";turbo=0";
+    tags += ";user-id=" + QByteArray::number(qHash(userName));
+    tags += ";user-type=";
+
+    return tags;
+}
+
+}  // namespace fakeircserver
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <QByteArray>
+#include <QString>
+#include <QStringList>
+
+#include <deque>
+#include <random>
+
+namespace fakeircserver {
+
+struct LoadOptions {
+    // messages per second generated in every joined channel
+    double messagesPerSecond = 5.0;
+
+    // chance for a single word to be a twitch emote/an emoji
+    double emoteDensity = 0.1;
+    double emojiDensity = 0.02;
+
+    // chance for a message to be a long (~450 character) message
+    double longMessageRatio = 0.05;
+
+    // chance for a message to contain a cheer
+    double bitsRatio = 0.01;
+
+    // chance for a message to repeat one of the last few generated messages (copypastas)
+    double copypastaRatio = 0.0;
+
+    // chance for an event to be a CLEARCHAT/USERNOTICE instead of a PRIVMSG
+    double clearChatRatio = 0.002;
+    double userNoticeRatio = 0.005;
+
+    // number of distinct fake chatters per channel
+    int userCount = 500;
+};
+
+class LoadGenerator
+{
+public:
+    explicit LoadGenerator(const LoadOptions &_options);
+
+    const LoadOptions &getOptions() const;
+
+    // Returns one full IRC line (including the trailing \r\n) for the given channel
+    QByteArray generateEvent(const QString &channelName);
+
+    QByteArray generatePrivateMessage(const QString &channelName);
+    QByteArray generateClearChat(const QString &channelName);
+    QByteArray generateUserNotice(const QString &channelName);
+
+    static QString roomIdForChannel(const QString &channelName);
+
+private:
+    LoadOptions options;
+
+    std::mt19937 random;
+    std::uniform_real_distribution<double> chance;
+
+    unsigned long long nextMessageId = 0;
+
+    struct Content {
+        QString text;
+        QString emotesTag;
+        int bits;
+    };
+
+    // most recent first
+    std::deque<Content> recentContents;
+
+    bool roll(double probability);
+    int randomInt(int min, int max);
+
+    QString randomUserName();
+    QString randomColor();
+    QString randomBadges();
+    QString generateContent(QString &emotesTag, int &bits);
+    QByteArray buildUserTags(const QString &channelName, const QString &userName);
+};
+
+}  // namespace fakeircserver
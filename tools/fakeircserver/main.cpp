@@ -0,0 +1,85 @@
+#include "fakeapiserver.hpp"
+#include "fakeircserver.hpp"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+
+using namespace fakeircserver;
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication a(argc, argv);
+    QCoreApplication::setApplicationName("fakeircserver");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(
+        "Fake Twitch IRC server that feeds every joined channel with synthetic chat.\n"
+        "Point chatterino at it by setting /connection/twitch/host and "
+        "/connection/twitch/port in settings.json.");
+    parser.addHelpOption();
+
+    LoadOptions defaults;
+
+    QCommandLineOption portOption("port", "Port to listen on.", "port", "6667");
+    QCommandLineOption rateOption("rate", "Messages per second in every joined channel.", "rate",
+                                  QString::number(defaults.messagesPerSecond));
+    QCommandLineOption emoteOption("emote-density", "Chance for a word to be a twitch emote.",
+                                   "chance", QString::number(defaults.emoteDensity));
+    QCommandLineOption emojiOption("emoji-density", "Chance for a word to be an emoji.", "chance",
+                                   QString::number(defaults.emojiDensity));
+    QCommandLineOption longOption("long-messages", "Chance for a message to be ~450 characters.",
+                                  "chance", QString::number(defaults.longMessageRatio));
+    QCommandLineOption bitsOption("bits", "Chance for a message to contain a cheer.", "chance",
+                                  QString::number(defaults.bitsRatio));
+    QCommandLineOption copypastaOption("copypasta",
+                                       "Chance for a message to repeat a recent message.",
+                                       "chance", QString::number(defaults.copypastaRatio));
+    QCommandLineOption clearChatOption("clearchat", "Chance for an event to be a CLEARCHAT.",
+                                       "chance", QString::number(defaults.clearChatRatio));
+    QCommandLineOption userNoticeOption("usernotice", "Chance for an event to be a USERNOTICE.",
+                                        "chance", QString::number(defaults.userNoticeRatio));
+    QCommandLineOption usersOption("users", "Number of distinct fake chatters.", "count",
+                                   QString::number(defaults.userCount));
+
+    QCommandLineOption apiPortOption(
+        "api-port", "Port of the fake Twitch API (block list), 0 to disable it.", "port", "0");
+    QCommandLineOption blockedUsersOption("blocked-users", "Number of users on the block list.",
+                                          "count", "250");
+    QCommandLineOption apiFailureOption("api-failure-rate",
+                                        "Chance for a block/unblock request to fail.", "chance",
+                                        "0");
+
+    parser.addOptions({portOption, rateOption, emoteOption, emojiOption, longOption, bitsOption,
+                       copypastaOption, clearChatOption, userNoticeOption, usersOption,
+                       apiPortOption, blockedUsersOption, apiFailureOption});
+
+    parser.process(a);
+
+    LoadOptions options;
+    options.messagesPerSecond = parser.value(rateOption).toDouble();
+    options.emoteDensity = parser.value(emoteOption).toDouble();
+    options.emojiDensity = parser.value(emojiOption).toDouble();
+    options.longMessageRatio = parser.value(longOption).toDouble();
+    options.bitsRatio = parser.value(bitsOption).toDouble();
+    options.copypastaRatio = parser.value(copypastaOption).toDouble();
+    options.clearChatRatio = parser.value(clearChatOption).toDouble();
+    options.userNoticeRatio = parser.value(userNoticeOption).toDouble();
+    options.userCount = parser.value(usersOption).toInt();
+
+    FakeIrcServer server(options);
+
+    if (!server.listen(parser.value(portOption).toUShort())) {
+        return 1;
+    }
+
+    FakeApiServer apiServer(parser.value(blockedUsersOption).toInt(),
+                            parser.value(apiFailureOption).toDouble());
+
+    quint16 apiPort = parser.value(apiPortOption).toUShort();
+
+    if (apiPort != 0 && !apiServer.listen(apiPort)) {
+        return 1;
+    }
+
+    return a.exec();
+}
@@ -0,0 +1,29 @@
+#-------------------------------------------------
+#
+# Compares the throughput and allocations of RawIrcMessage against Communi::IrcMessage
+#
+#-------------------------------------------------
+
+QT      += core network
+QT      -= gui
+CONFIG  += c++14 console communi
+CONFIG  -= app_bundle
+COMMUNI += core
+
+DEFINES += IRC_NAMESPACE=Communi
+include(../../lib/libcommuni/src/src.pri)
+
+TARGET   = ircparserbench
+TEMPLATE = app
+
+INCLUDEPATH += ../../src/ ../fakeircserver/
+
+SOURCES += \
+    main.cpp \
+    ../fakeircserver/loadgenerator.cpp \
+    ../../src/twitch/rawircmessage.cpp
+
+HEADERS  += \
+    ../fakeircserver/loadgenerator.hpp \
+    ../../src/util/byteview.hpp \
+    ../../src/twitch/rawircmessage.hpp
@@ -0,0 +1,157 @@
+#include "loadgenerator.hpp"
+#include "twitch/rawircmessage.hpp"
+
+#include <IrcConnection>
+#include <IrcMessage>
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QTextStream>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <vector>
+
+// Count every heap allocation done by the process, so we can compare how many allocations
+// each parser does per line. Qt's containers (QByteArray, QString, QVariant, QHash) allocate
+// through malloc rather than operator new, so the allocator itself is wrapped: a malloc defined
+// in the executable takes precedence over the one in libc for all libraries, and operator new
+// ends up in it too.
+static std::atomic<unsigned long long> allocationCount(0);
+
+#ifdef __GLIBC__
+#define ALLOCATIONS_COUNTED 1
+
+extern "C" {
+
+void *__libc_malloc(std::size_t size);
+void *__libc_calloc(std::size_t count, std::size_t size);
+void *__libc_realloc(void *ptr, std::size_t size);
+
+void *malloc(std::size_t size)
+{
+    allocationCount++;
+
+    return __libc_malloc(size);
+}
+
+void *calloc(std::size_t count, std::size_t size)
+{
+    allocationCount++;
+
+    return __libc_calloc(count, size);
+}
+
+// growing a QByteArray/QString in place reallocates, which costs like an allocation
+void *realloc(void *ptr, std::size_t size)
+{
+    allocationCount++;
+
+    return __libc_realloc(ptr, size);
+}
+
+}  // extern "C"
+#else
+#define ALLOCATIONS_COUNTED 0
+#endif
+
+namespace {
+
+struct Result {
+    double linesPerSecond;
+    double allocationsPerLine;
+};
+
+template <typename Parse>
+Result run(const std::vector<QByteArray> &lines, int iterations, Parse parse)
+{
+    unsigned long long allocationsBefore = allocationCount;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    for (int i = 0; i < iterations; i++) {
+        for (const QByteArray &line : lines) {
+            parse(line);
+        }
+    }
+
+    qint64 elapsed = std::max<qint64>(timer.nsecsElapsed(), 1);
+    double totalLines = static_cast<double>(lines.size()) * iterations;
+
+    Result result;
+    result.linesPerSecond = totalLines * 1e9 / elapsed;
+    result.allocationsPerLine = (allocationCount - allocationsBefore) / totalLines;
+
+    return result;
+}
+
+}  // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(
+        "Compares the IRC parser used by chatterino against Communi::IrcMessage");
+    parser.addHelpOption();
+    parser.addOption({"lines", "Number of distinct lines to generate", "count", "10000"});
+    parser.addOption({"iterations", "How often every line is parsed", "count", "20"});
+    parser.process(app);
+
+    int lineCount = parser.value("lines").toInt();
+    int iterations = parser.value("iterations").toInt();
+
+    // generate the same kind of traffic the fake irc server sends
+    fakeircserver::LoadOptions options;
+    fakeircserver::LoadGenerator generator(options);
+
+    std::vector<QByteArray> lines;
+    lines.reserve(lineCount);
+
+    for (int i = 0; i < lineCount; i++) {
+        QByteArray line = generator.generateEvent("channel" + QString::number(i % 20));
+        line.chop(2);  // \r\n
+
+        lines.push_back(line);
+    }
+
+    QTextStream out(stdout);
+
+    // RawIrcMessage: the message is reused for every line, just like in TwitchConnection
+    chatterino::twitch::RawIrcMessage rawMessage;
+    unsigned long long checksum = 0;
+
+    Result raw = run(lines, iterations, [&](const QByteArray &line) {
+        chatterino::twitch::RawIrcMessage::parse(line, rawMessage);
+        checksum += rawMessage.getRawTag("emotes").getSize();
+    });
+
+    // Communi: a QObject is created (and tags/params are converted to QVariants) for every line
+    Communi::IrcConnection connection;
+
+    Result communi = run(lines, iterations, [&](const QByteArray &line) {
+        Communi::IrcMessage *message = Communi::IrcMessage::fromData(line, &connection);
+        checksum += message->tags().value("emotes").toString().size();
+        delete message;
+    });
+
+    out << "lines: " << lines.size() << ", iterations: " << iterations << "\n";
+
+    if (ALLOCATIONS_COUNTED) {
+        out << "RawIrcMessage:       " << raw.linesPerSecond << " lines/s, "
+            << raw.allocationsPerLine << " allocations/line\n";
+        out << "Communi::IrcMessage: " << communi.linesPerSecond << " lines/s, "
+            << communi.allocationsPerLine << " allocations/line\n";
+    } else {
+        // without glibc's malloc there is nothing to wrap, only the throughput is compared
+        out << "RawIrcMessage:       " << raw.linesPerSecond << " lines/s\n";
+        out << "Communi::IrcMessage: " << communi.linesPerSecond << " lines/s\n";
+    }
+    out << "(checksum " << checksum << ")\n";
+
+    return 0;
+}